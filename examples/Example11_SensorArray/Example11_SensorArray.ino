@@ -0,0 +1,67 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example reads eight SGP30s connected to the channels of a
+  TCA9548A I2C multiplexer (such as the SparkFun Qwiic Mux) at 0x70.
+  All eight sensors measure at the same time, so the whole array only
+  waits 12ms per reading instead of 12ms per sensor.
+*/
+
+#include "SparkFun_SGP30_Array.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include <Wire.h>
+
+#define NUMBER_OF_SENSORS 8
+
+SGP30Array<NUMBER_OF_SENSORS> mySensors; //sensor i is on mux channel i
+unsigned long t1;
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Sensor supports I2C speeds up to 400kHz
+  Wire.setClock(400000);
+  //Initialize every sensor behind the mux at 0x70
+  byte found = mySensors.begin(Wire, 0x70);
+  Serial.print("SGP30s detected: ");
+  Serial.println(found);
+  //Initializes sensors for air quality readings
+  //measureAirQuality should be called in one second increments after a call to initAirQuality
+  mySensors.initAirQuality();
+  t1 = millis();
+}
+
+void loop() {
+  //First fifteen readings will be
+  //CO2: 400 ppm  TVOC: 0 ppb
+  if (millis() - t1 >= 1000) //only will occur if 1 second has passed
+  {
+    t1 += 1000;
+    mySensors.measureAirQuality();
+    for (byte i = 0; i < NUMBER_OF_SENSORS; i++)
+    {
+      Serial.print(i);
+      if (mySensors.status[i] == SGP30_SUCCESS) {
+        Serial.print("\tCO2: ");
+        Serial.print(mySensors.sensors[i].CO2);
+        Serial.print(" ppm\tTVOC: ");
+        Serial.print(mySensors.sensors[i].TVOC);
+        Serial.println(" ppb");
+      }
+      else if (mySensors.status[i] == SGP30_ERR_BAD_CRC) {
+        Serial.println("\tCRC Failed");
+      }
+      else {
+        Serial.println("\tI2C Timed out");
+      }
+    }
+  }
+}
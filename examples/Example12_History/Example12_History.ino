@@ -0,0 +1,64 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example keeps the last 60 readings in a history attached to the
+  sensor and prints the running statistics the history maintains.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30History<60> history; //room for 60 readings, 13 bytes each
+unsigned long t1;
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Sensor supports I2C speeds up to 400kHz
+  Wire.setClock(400000);
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  //Every successful measureAirQuality() now adds a sample to history
+  mySensor.attachHistory(history);
+  //Initializes sensor for air quality readings
+  //measureAirQuality should be called in one second increments after a call to initAirQuality
+  mySensor.initAirQuality();
+  t1 = millis();
+}
+
+void loop() {
+  //First fifteen readings will be
+  //CO2: 400 ppm  TVOC: 0 ppb
+  if (millis() - t1 >= 1000) //only will occur if 1 second has passed
+  {
+    t1 += 1000;
+    if (mySensor.measureAirQuality() == SGP30_SUCCESS) {
+      Serial.print("CO2: ");
+      Serial.print(mySensor.CO2);
+      Serial.print(" ppm\tmin: ");
+      Serial.print(history.minimum(SGP30_SIGNAL_CO2));
+      Serial.print("\tmax: ");
+      Serial.print(history.maximum(SGP30_SIGNAL_CO2));
+      Serial.print("\tEMA: ");
+      Serial.print(history.ema(SGP30_SIGNAL_CO2));
+      Serial.print("\t1 min mean: ");
+      Serial.print(history.windowMean(SGP30_SIGNAL_CO2, SGP30_WINDOW_1MIN));
+      Serial.print("\tTVOC 1 min mean: ");
+      Serial.print(history.windowMean(SGP30_SIGNAL_TVOC, SGP30_WINDOW_1MIN));
+      Serial.println(" ppb");
+    }
+  }
+}
@@ -0,0 +1,64 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example lets the library look after the baseline. It is saved to
+  EEPROM 12 hours after the first start and every hour after that, and
+  restored automatically by initAirQuality() after a reset or power cycle,
+  so the sensor doesn't have to calibrate from scratch every time.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include "SparkFun_SGP30_EEPROM.h"
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30EEPROMStorage storage(0, 200); //use EEPROM bytes 0-199, room for 10 records
+SGP30BaselineManager baselineManager(storage);
+unsigned long t1;
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Sensor supports I2C speeds up to 400kHz
+  Wire.setClock(400000);
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  //Attach before initAirQuality so a stored baseline can be restored
+  mySensor.attachBaselineManager(baselineManager);
+  //Initializes sensor for air quality readings
+  //measureAirQuality should be called in one second increments after a call to initAirQuality
+  mySensor.initAirQuality();
+  if (baselineManager.restored())
+    Serial.println("Restored baseline from EEPROM");
+  else
+    Serial.println("No stored baseline, calibrating from scratch");
+  t1 = millis();
+}
+
+void loop() {
+  //First fifteen readings will be
+  //CO2: 400 ppm  TVOC: 0 ppb
+  if (millis() - t1 >= 1000) //only will occur if 1 second has passed
+  {
+    t1 += 1000;
+    mySensor.measureAirQuality(); //also saves the baseline when it is due
+    Serial.print("CO2: ");
+    Serial.print(mySensor.CO2);
+    Serial.print(" ppm\tTVOC: ");
+    Serial.print(mySensor.TVOC);
+    Serial.print(" ppb\tbaseline saves: ");
+    Serial.println(baselineManager.writes);
+  }
+}
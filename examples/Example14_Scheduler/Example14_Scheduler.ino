@@ -0,0 +1,72 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example keeps air quality measurements on an exact 1 second cadence
+  with SGP30Scheduler. Every measurement is due a whole second after the
+  previous deadline, so time spent measuring or printing does not add up
+  to drift. Between measurements the sketch sleeps for msUntilNext().
+  Every minute it prints how well the cadence was kept.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include "SparkFun_SGP30_Scheduler.h"
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30Scheduler scheduler; //1 second period
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  //Initializes sensor for air quality readings
+  mySensor.initAirQuality();
+  delay(10); //init takes up to 10ms
+  //First measurement right away, then one every second
+  scheduler.begin(mySensor);
+}
+
+void loop() {
+  //First fifteen readings will be
+  //CO2: 400 ppm  TVOC: 0 ppb
+  SGP30ERR error = scheduler.update();
+  if (error == SGP30_SUCCESS) {
+    Serial.print("CO2: ");
+    Serial.print(mySensor.CO2);
+    Serial.print(" ppm\tTVOC: ");
+    Serial.print(mySensor.TVOC);
+    Serial.println(" ppb");
+
+    if (scheduler.ticks % 60 == 0) {
+      Serial.print("Cadence over ");
+      Serial.print(scheduler.ticks);
+      Serial.print(" ticks: jitter max ");
+      Serial.print(scheduler.maxJitter);
+      Serial.print(" us, mean ");
+      Serial.print(scheduler.meanJitter());
+      Serial.print(" us, missed ");
+      Serial.println(scheduler.missed);
+    }
+  }
+  else if (error == SGP30_ERR_BAD_CRC) {
+    Serial.println("CRC Failed");
+  }
+  else if (error == SGP30_ERR_I2C_TIMEOUT) {
+    Serial.println("I2C Timed out");
+  }
+  //Nothing to do until then, a low power sleep would go here
+  delay(scheduler.msUntilNext());
+}
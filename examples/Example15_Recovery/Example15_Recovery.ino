@@ -0,0 +1,75 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example keeps the sensor reporting through bus glitches with SGP30Recovery.
+  Failed measurements are retried, and if they keep failing the sensor is reset
+  and re-initialized with its baseline and humidity compensation restored.
+  Try unplugging the sensor for a few seconds and plugging it back in.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include "SparkFun_SGP30_Recovery.h"
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30Recovery recovery;
+long t1;
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  //Retry twice, 5 then 10ms apart, and re-initialize after 3 failures in a row,
+  //giving up after 4 resets that don't bring the sensor back
+  recovery.setRetries(2, 5, 100);
+  recovery.setEscalation(3, 4);
+  mySensor.attachRecovery(recovery);
+  //Initializes sensor for air quality readings
+  mySensor.initAirQuality();
+  t1 = millis();
+}
+
+void loop() {
+  if (millis() - t1 >= 1000) //only will occur if 1 second has passed
+  {
+    t1 += 1000;
+    mySensor.measureAirQuality();
+    Serial.print("CO2: ");
+    Serial.print(mySensor.CO2);
+    Serial.print(" ppm\tTVOC: ");
+    Serial.print(mySensor.TVOC);
+    Serial.print(" ppb\t");
+    switch (recovery.state()) {
+      case SGP30_STATE_WARMUP:
+        Serial.print("warming up");
+        break;
+      case SGP30_STATE_OK:
+        Serial.print("ok");
+        break;
+      case SGP30_STATE_DEGRADED:
+        Serial.print("stale, failures: ");
+        Serial.print(recovery.failures());
+        break;
+      case SGP30_STATE_FAILED:
+        Serial.print("sensor lost");
+        break;
+    }
+    Serial.print("\tretries: ");
+    Serial.print(recovery.retried);
+    Serial.print(" recoveries: ");
+    Serial.println(recovery.recoveries);
+  }
+}
@@ -0,0 +1,58 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example streams every reading in the compact binary log format,
+  about 6 to 9 bytes per reading instead of about 60 bytes of text.
+  Any Print works as the output: Serial here, an SD card File the same way.
+  The output is binary, so capture it to a file instead of reading it in
+  the serial monitor, then convert it to CSV on a computer with
+  extras/host/sgp30_log: sgp30_log decode capture.bin > readings.csv
+  Capture can start at any point, decoding starts at the next keyframe.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include "SparkFun_SGP30_Log.h"
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30LogEncoder logger(Serial);
+
+void setup() {
+  Serial.begin(115200);
+  Wire.begin();
+  //Initialize sensor, nothing is printed as text from here on
+  if (mySensor.begin() == false) {
+    while (1);
+  }
+  //Initializes sensor for air quality readings
+  mySensor.initAirQuality();
+  //The header carries the serial ID and feature set read by begin()
+  logger.begin(mySensor, 1000);
+  //Samples are buffered 4 to a frame, a keyframe every minute
+  logger.setBatch(4);
+  logger.setKeyframeInterval(60);
+}
+
+void loop() {
+  //First fifteen readings will be
+  //CO2: 400 ppm  TVOC: 0 ppb
+  delay(1000); //Wait 1 second
+  SGP30Sample sample;
+  sample.timestamp = millis();
+  if (mySensor.measureAirQuality() != SGP30_SUCCESS || mySensor.measureRawSignals() != SGP30_SUCCESS)
+    return; //skipped samples show as a longer interval in the log
+  sample.CO2 = mySensor.CO2;
+  sample.TVOC = mySensor.TVOC;
+  sample.H2 = mySensor.H2;
+  sample.ethanol = mySensor.ethanol;
+  logger.write(sample);
+}
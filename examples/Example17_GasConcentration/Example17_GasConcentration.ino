@@ -0,0 +1,59 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example converts the raw H2 and ethanol signals to concentrations
+  in ppb with integer math only. The conversion needs the signal each gas
+  gives in clean air, which varies from sensor to sensor: the first minute
+  of readings is used to calibrate it, so start the sketch in fresh air.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include "SparkFun_SGP30_Gas.h"
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30GasConverter converter; //starts from typical clean air signals
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  //Average the first 60 readings into the clean air signals
+  converter.startCalibration(60);
+  Serial.println("Calibrating, keep the sensor in clean air for a minute");
+}
+
+void loop() {
+  delay(1000); //Wait 1 second
+  if (mySensor.measureRawSignals() != SGP30_SUCCESS) {
+    Serial.println("Read failed");
+    return;
+  }
+  if (converter.calibrating()) {
+    if (converter.calibrate(mySensor.H2, mySensor.ethanol)) {
+      Serial.print("Clean air signals: H2 ");
+      Serial.print(converter.referenceH2);
+      Serial.print(" \tEthanol ");
+      Serial.println(converter.referenceEthanol);
+    }
+    return;
+  }
+  Serial.print("H2: ");
+  Serial.print(converter.H2(mySensor.H2));
+  Serial.print(" ppb\tEthanol: ");
+  Serial.print(converter.ethanol(mySensor.ethanol));
+  Serial.println(" ppb");
+}
@@ -0,0 +1,60 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example reads CO2 and TVOC with BasicSGP30, a driver that only
+  contains the features it is given. Here that is the baseline, printed
+  every hour so it can be saved and restored after a power cycle. Features
+  left out (raw signals, serial ID, self test, humidity...) take no RAM or
+  flash, which leaves room for other sensors on small boards like the Uno.
+*/
+
+#include "SparkFun_SGP30_Basic.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include <Wire.h>
+
+BasicSGP30<SGP30Baselines> mySensor; //air quality and baseline only
+
+unsigned long baselineTime;
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  //Initializes sensor for air quality readings
+  //measureAirQuality should be called in one second increments after a call to initAirQuality
+  mySensor.initAirQuality();
+  baselineTime = millis();
+}
+
+void loop() {
+  delay(1000); //Wait 1 second
+  //measure CO2 and TVOC levels
+  if (mySensor.measureAirQuality() == SGP30_SUCCESS) {
+    Serial.print("CO2: ");
+    Serial.print(mySensor.CO2);
+    Serial.print(" ppm\tTVOC: ");
+    Serial.print(mySensor.TVOC);
+    Serial.println(" ppb");
+  }
+  if (millis() - baselineTime >= 3600000UL) {
+    baselineTime += 3600000UL;
+    if (mySensor.getBaseline() == SGP30_SUCCESS) {
+      Serial.print("Baseline CO2: 0x");
+      Serial.print(mySensor.baselineCO2, HEX);
+      Serial.print("\tTVOC: 0x");
+      Serial.println(mySensor.baselineTVOC, HEX);
+    }
+  }
+}
@@ -0,0 +1,77 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example keeps an eye on the sensor's health while it measures.
+  SGP30HealthMonitor runs the on chip self test once a day without
+  stopping the loop for its 220ms, and restores the baseline afterwards.
+  Between tests it follows bus errors, stuck readings and the drift of the
+  raw signals, sampled once a minute, and sums them up in a score out of 100.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include "SparkFun_SGP30_Scheduler.h"
+#include "SparkFun_SGP30_Health.h"
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30Scheduler scheduler; //1 second period
+SGP30HealthMonitor monitor;
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  mySensor.initAirQuality();
+  delay(10); //init takes up to 10ms
+  scheduler.begin(mySensor);
+  monitor.begin(mySensor);
+}
+
+void loop() {
+  SGP30ERR error = scheduler.update();
+  monitor.recordAirQuality(error);
+  if (error == SGP30_SUCCESS) {
+    Serial.print("CO2: ");
+    Serial.print(mySensor.CO2);
+    Serial.print(" ppm\tTVOC: ");
+    Serial.print(mySensor.TVOC);
+    Serial.println(" ppb");
+
+    //Raw signals once a minute, right after a reading so the sensor is idle
+    if (scheduler.ticks % 60 == 0) {
+      monitor.recordRawSignals(mySensor.measureRawSignals());
+      Serial.print("Health: ");
+      Serial.print(monitor.score());
+      Serial.print("\terror rate: ");
+      Serial.print(monitor.errorRate());
+      Serial.print("/1000\tdrift: ");
+      Serial.print(monitor.drift());
+      Serial.println(monitor.stuck() ? "\tstuck" : "");
+    }
+    //Self test once a day
+    if (scheduler.ticks % 86400 == 0)
+      monitor.startTest();
+  }
+
+  error = monitor.update();
+  if (error == SGP30_SUCCESS) {
+    Serial.println("Self test passed");
+  }
+  else if (error != SGP30_ERR_NOT_READY) {
+    Serial.println("Self test failed");
+  }
+  delay(monitor.testing() ? 1 : scheduler.msUntilNext());
+}
@@ -0,0 +1,72 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example turns a ventilation output on and off from alert rules.
+  SGP30Alerts checks every reading as it is measured: the fan goes on
+  once CO2 reaches 1000 ppm and stays on until it is back under 800 ppm,
+  and a message is printed while TVOC climbs faster than 100 ppb per
+  minute, averaged over the last 5 minutes. Three readings in a row are
+  needed before the CO2 rule changes its mind.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include <Wire.h>
+
+#define FAN_PIN 13
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30Alerts<2> alerts;
+uint8_t co2Rule;
+uint8_t tvocRule;
+
+//Called from inside measureAirQuality() when a rule turns on or off
+void changed(uint8_t rule, bool active, const SGP30Sample &sample, void *context) {
+  if (rule == co2Rule) {
+    digitalWrite(FAN_PIN, active ? HIGH : LOW);
+    Serial.print(active ? "Fan on at " : "Fan off at ");
+    Serial.print(sample.CO2);
+    Serial.println(" ppm");
+  }
+  else if (rule == tvocRule && active) {
+    Serial.print("TVOC rising: ");
+    Serial.print(alerts.slope(tvocRule));
+    Serial.println(" ppb/min");
+  }
+}
+
+void setup() {
+  Serial.begin(9600);
+  Wire.begin();
+  pinMode(FAN_PIN, OUTPUT);
+  //Initialize sensor
+  if (mySensor.begin() == false) {
+    Serial.println("No SGP30 Detected. Check connections.");
+    while (1);
+  }
+  co2Rule = alerts.addAbove(SGP30_SIGNAL_CO2, 1000, 800, changed);
+  alerts.setDebounce(co2Rule, 3);
+  tvocRule = alerts.addRising(SGP30_SIGNAL_TVOC, 100, 20, 300000, changed);
+  mySensor.attachAlerts(alerts);
+  mySensor.initAirQuality();
+}
+
+void loop() {
+  //First fifteen readings will be
+  //CO2: 400 ppm  TVOC: 0 ppb
+  delay(1000); //Wait 1 second
+  mySensor.measureAirQuality();
+  Serial.print("CO2: ");
+  Serial.print(mySensor.CO2);
+  Serial.print(" ppm\tTVOC: ");
+  Serial.print(mySensor.TVOC);
+  Serial.println(" ppb");
+}
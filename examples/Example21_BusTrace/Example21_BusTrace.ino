@@ -0,0 +1,49 @@
+/*
+  Library for the Sensirion SGP30 Indoor Air Quality Sensor
+  By: Ciara Jekel
+  SparkFun Electronics
+  Date: June 28th, 2018
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  SGP30 Datasheet: https://cdn.sparkfun.com/assets/c/0/a/2/e/Sensirion_Gas_Sensors_SGP30_Datasheet.pdf
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/14813
+
+  This example records every I2C transaction with the sensor, to reproduce
+  on the bench what a unit did in the field. Each command, the bytes the
+  sensor answered and whether it acknowledged go out with a timestamp,
+  about 13 bytes per reading.
+  The output is binary, so capture it to a file instead of reading it in
+  the serial monitor (an SD card File works the same way), then list it on
+  a computer with extras/host/sgp30_trace: sgp30_trace dump capture.bin
+  extras/host/SGP30Replay.h replays it through the driver: running this
+  same loop against the replay gives back the same readings and errors.
+*/
+
+#include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
+#include "SparkFun_SGP30_Trace.h"
+#include <Wire.h>
+
+SGP30 mySensor; //create an object of the SGP30 class
+SGP30TraceRecorder recorder(Serial);
+
+void setup() {
+  Serial.begin(115200);
+  Wire.begin();
+  //Attached before begin() so the trace holds the whole conversation
+  mySensor.attachRecorder(recorder);
+  //Initialize sensor, nothing is printed as text from here on
+  if (mySensor.begin() == false) {
+    while (1);
+  }
+  //Initializes sensor for air quality readings
+  mySensor.initAirQuality();
+}
+
+void loop() {
+  //First fifteen readings will be
+  //CO2: 400 ppm  TVOC: 0 ppb
+  delay(1000); //Wait 1 second
+  mySensor.measureAirQuality();
+}
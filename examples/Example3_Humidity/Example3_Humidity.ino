@@ -12,6 +12,8 @@
 
   This example gets relative humidity from a sensor, converts it to absolute humidty,
   and updates the SGP30's humidity compensation with the absolute humidity value.
+  setRelativeHumidity() does the conversion with integer math only, and skips the
+  update when absolute humidity has barely changed since the last one.
 */
 
 #include "SparkFun_SGP30_Arduino_Library.h" // Click here to get the library: http://librarymanager/All#SparkFun_SGP30
@@ -45,21 +47,17 @@ void setup() {
   //Measure temperature (in C) from the SHTC3
   float temperature = humiditySensor.toDegC();
 
-  //Convert relative humidity to absolute humidity
-  double absHumidity = RHtoAbsolute(humidity, temperature);
-
-  //Convert the double type humidity to a fixed point 8.8bit number
-  uint16_t sensHumidity = doubleToFixedPoint(absHumidity);
-
   //Initializes sensor for air quality readings
   //measureAirQuality should be called in one second increments after a call to initAirQuality
   mySensor.initAirQuality();
+  delay(10); //init takes up to 10ms
 
   //Set the humidity compensation on the SGP30 to the measured value
-  //If no humidity sensor attached, sensHumidity should be 0 and sensor will use default
-  mySensor.setHumidity(sensHumidity);
+  //Temperature in hundredths of a degree C, relative humidity in hundredths of a percent
+  //If no humidity sensor attached, skip this and the sensor will use its default
+  mySensor.setRelativeHumidity(temperature * 100, humidity * 100);
   Serial.print("Absolute humidity compensation set to: ");
-  Serial.print(absHumidity);
+  Serial.print(sgp30AbsoluteHumidity(temperature * 100, humidity * 100) / 256.0);
   Serial.println("g/m^3 ");
   delay(100);
   t1 = millis();
@@ -91,33 +89,17 @@ void loop() {
       //Measure temperature (in C) from the SHTC3
       float temperature = humiditySensor.toDegC();
     
-      //Convert relative humidity to absolute humidity
-      double absHumidity = RHtoAbsolute(humidity, temperature);
-    
-      //Convert the double type humidity to a fixed point 8.8bit number
-      uint16_t sensHumidity = doubleToFixedPoint(absHumidity);
-    
       //Set the humidity compensation on the SGP30 to the measured value
-      //If no humidity sensor attached, sensHumidity should be 0 and sensor will use default
-      mySensor.setHumidity(sensHumidity);
-      Serial.print("Absolute Humidity Compensation set to: ");
-      Serial.print(absHumidity);
-      Serial.println("g/m^3 ");
+      //Returns false if absolute humidity is within 1/16 g/m^3 of the last update
+      if (mySensor.setRelativeHumidity(temperature * 100, humidity * 100))
+      {
+        Serial.print("Absolute Humidity Compensation set to: ");
+        Serial.print(sgp30AbsoluteHumidity(temperature * 100, humidity * 100) / 256.0);
+        Serial.println("g/m^3 ");
+      }
+      else
+        Serial.println("Humidity unchanged, compensation not updated");
       delay(100);      
     }
   }
 }
-
-double RHtoAbsolute (float relHumidity, float tempC) {
-  double eSat = 6.11 * pow(10.0, (7.5 * tempC / (237.7 + tempC)));
-  double vaporPressure = (relHumidity * eSat) / 100; //millibars
-  double absHumidity = 1000 * vaporPressure * 100 / ((tempC + 273) * 461.5); //Ideal gas law with unit conversions
-  return absHumidity;
-}
-
-uint16_t doubleToFixedPoint( double number) {
-  int power = 1 << 8;
-  double number2 = number * power;
-  uint16_t value = floor(number2 + 0.5);
-  return value;
-}
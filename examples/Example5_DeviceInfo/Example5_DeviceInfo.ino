@@ -36,6 +36,12 @@ void setup() {
   Serial.print((unsigned long)mySensor.serialID, HEX);
   Serial.print("\tFeature Set Version: 0x");
   Serial.println(mySensor.featureSetVersion, HEX);
+  //Newer feature sets can start TVOC from the inceptive baseline after power up
+  Serial.print("TVOC inceptive baseline: ");
+  if (mySensor.supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE | SGP30_CAP_SET_TVOC_BASELINE))
+    Serial.println("supported, used by initAirQuality() after setFastStartup(true)");
+  else
+    Serial.println("not supported by this feature set");
 }
 
 void loop() {
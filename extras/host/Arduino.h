@@ -0,0 +1,58 @@
+/*
+  Host (Linux) stand-in for the Arduino core, used to build and benchmark
+  the SGP30 library without hardware. Only what the library uses is here.
+
+  Time is simulated: millis()/micros() read a clock that only moves when
+  delay() is called or when a transaction is clocked over the fake bus, so
+  runs are deterministic and never actually sleep.
+  Built with -DHOST_REAL_CLOCK the clock is the monotonic clock instead and
+  delay() sleeps, for programs talking to real hardware (sgp30_linux).
+*/
+
+#ifndef Host_Arduino_h
+#define Host_Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#define ARDUINO_HOST 1
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+
+#define DEC 10
+#define HEX 16
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+//Base of every output stream (Serial, SD files...) in the Arduino core
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t data) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t written = 0;
+    while (size-- && write(*buffer++))
+      written++;
+    return written;
+  }
+};
+
+//Simulated clock control
+uint64_t hostMicros(void);                  //full 64 bit simulated time
+void hostAdvanceMicros(uint64_t us);        //move the clock forward
+void hostSetMicros(uint64_t us);            //jump the clock, e.g. to test millis() rollover
+
+#endif
@@ -0,0 +1,208 @@
+/*
+  Host (Linux) stand-in for the Arduino core and Wire library.
+  See Arduino.h and Wire.h.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#ifdef HOST_REAL_CLOCK
+#include <time.h>
+#endif
+
+//Simulated time, or with HOST_REAL_CLOCK an offset added to the monotonic clock
+static uint64_t hostClock = 0;
+
+unsigned long millis(void)
+{
+  return (unsigned long)(uint32_t)(hostMicros() / 1000);
+}
+
+unsigned long micros(void)
+{
+  return (unsigned long)(uint32_t)hostMicros();
+}
+
+void delay(unsigned long ms)
+{
+#ifdef HOST_REAL_CLOCK
+  struct timespec wait = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+  while (nanosleep(&wait, &wait) != 0)
+    ; //interrupted by a signal, sleep the rest
+#else
+  hostClock += (uint64_t)ms * 1000;
+#endif
+}
+
+void delayMicroseconds(unsigned int us)
+{
+#ifdef HOST_REAL_CLOCK
+  struct timespec wait = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000L};
+  while (nanosleep(&wait, &wait) != 0)
+    ;
+#else
+  hostClock += us;
+#endif
+}
+
+uint64_t hostMicros(void)
+{
+#ifdef HOST_REAL_CLOCK
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return hostClock + (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#else
+  return hostClock;
+#endif
+}
+
+void hostAdvanceMicros(uint64_t us)
+{
+  hostClock += us;
+}
+
+void hostSetMicros(uint64_t us)
+{
+  hostClock += us - hostMicros();
+}
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+{
+  _deviceCount = 0;
+  _clock = 100000;
+  _txAddress = 0;
+  _txLength = 0;
+  _rxLength = 0;
+  _rxIndex = 0;
+  resetStats();
+}
+
+void TwoWire::attach(uint8_t address, HostI2CDevice *device)
+{
+  if (_deviceCount < HOST_WIRE_MAX_DEVICES)
+  {
+    _devices[_deviceCount].address = address;
+    _devices[_deviceCount].device = device;
+    _deviceCount++;
+  }
+}
+
+void TwoWire::detachAll(void)
+{
+  _deviceCount = 0;
+}
+
+void TwoWire::resetStats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  _txAddress = address;
+  _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (_txLength >= HOST_WIRE_BUFFER_LENGTH)
+    return 0;
+  _txBuffer[_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length)
+{
+  size_t written = 0;
+  while (written < length && write(data[written]))
+    written++;
+  return written;
+}
+
+//Returns 0 on success, 2 on address NACK, 3 on data NACK like the AVR core
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  (void)sendStop;
+  stats.transactions++;
+  if (_txAddress == 0x00)
+  {
+    //General call goes to everybody, nobody in particular acknowledges
+    _clockBus(_txLength);
+    stats.bytesWritten += _txLength;
+    for (uint8_t i = 0; i < _deviceCount; i++)
+      if (_txLength > 0)
+        _devices[i].device->onGeneralCall(_txBuffer[0]);
+    return 0;
+  }
+  HostI2CDevice *device = _find(_txAddress);
+  if (device == NULL)
+  {
+    _clockBus(0);
+    stats.nacks++;
+    return 2;
+  }
+  _clockBus(_txLength);
+  if (!device->onWrite(_txBuffer, _txLength))
+  {
+    stats.nacks++;
+    return 3;
+  }
+  stats.bytesWritten += _txLength;
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop)
+{
+  (void)sendStop;
+  stats.transactions++;
+  _rxIndex = 0;
+  _rxLength = 0;
+  if (quantity > HOST_WIRE_BUFFER_LENGTH)
+    quantity = HOST_WIRE_BUFFER_LENGTH;
+  HostI2CDevice *device = _find(address);
+  if (device != NULL)
+    _rxLength = device->onRead(_rxBuffer, quantity);
+  if (_rxLength == 0)
+    stats.nacks++;
+  _clockBus(_rxLength);
+  stats.bytesRead += _rxLength;
+  return (uint8_t)_rxLength;
+}
+
+int TwoWire::available(void)
+{
+  return (int)(_rxLength - _rxIndex);
+}
+
+int TwoWire::read(void)
+{
+  if (_rxIndex >= _rxLength)
+    return -1;
+  return _rxBuffer[_rxIndex++];
+}
+
+//Finds the device that acknowledges address, looking through muxes
+HostI2CDevice *TwoWire::_find(uint8_t address)
+{
+  for (uint8_t i = 0; i < _deviceCount; i++)
+    if (_devices[i].address == address)
+      return _devices[i].device;
+  for (uint8_t i = 0; i < _deviceCount; i++)
+  {
+    HostI2CDevice *routed = _devices[i].device->route(address);
+    if (routed != NULL)
+      return routed;
+  }
+  return NULL;
+}
+
+//Start + address byte + payload bytes + stop, 9 clocks per byte
+void TwoWire::_clockBus(size_t bytes)
+{
+  uint64_t bits = 2 + 9 * (uint64_t)(bytes + 1);
+  uint64_t us = (bits * 1000000 + _clock - 1) / _clock;
+  stats.busMicros += us;
+  hostClock += us;
+}
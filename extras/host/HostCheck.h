@@ -0,0 +1,38 @@
+/*
+  Checks shared by the host benchmarks and tools.
+
+  CHECK() reports a failed condition with its file and line and carries on,
+  so one run lists every failure. main() ends with checkSummary(), which
+  prints the outcome and returns the exit status: non-zero if any check
+  failed, so the programs can run in CI.
+*/
+
+#ifndef HostCheck_h
+#define HostCheck_h
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                 \
+  do                                                                     \
+  {                                                                      \
+    if (!(condition))                                                    \
+    {                                                                    \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition);        \
+      failures++;                                                        \
+    }                                                                    \
+  } while (0)
+
+static inline int checkSummary(void)
+{
+  if (failures)
+  {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+  File storage for SGP30BaselineManager on Linux.
+
+  The region is a plain file. With a page size it behaves like flash:
+  erase() fills one page with 0xFF and write() refuses to program bytes
+  that are not erased, so the manager's erase path is exercised too.
+  Setting failWrites makes every write fail, like a power loss.
+*/
+
+#ifndef SGP30FileStorage_h
+#define SGP30FileStorage_h
+
+#include <stdio.h>
+#include "SparkFun_SGP30_Baseline.h"
+
+class SGP30FileStorage : public SGP30BaselineStorage
+{
+public:
+  unsigned long erases;
+  unsigned long byteWrites[1024]; //writes per byte, for wear checks
+  bool failWrites;
+
+  SGP30FileStorage(const char *path, uint16_t length, uint16_t pageSize = 0)
+  {
+    _path = path;
+    _length = length > 1024 ? 1024 : length;
+    _pageSize = pageSize;
+    erases = 0;
+    failWrites = false;
+    memset(byteWrites, 0, sizeof(byteWrites));
+    //Create the file blank if it does not exist yet
+    FILE *file = fopen(_path, "rb");
+    if (file != NULL)
+      fclose(file);
+    else
+      _fill(0xFF);
+  }
+
+  uint16_t size(void) { return _length; }
+
+  void read(uint16_t address, uint8_t *data, uint8_t length)
+  {
+    memset(data, 0xFF, length);
+    FILE *file = fopen(_path, "rb");
+    if (file == NULL)
+      return;
+    if (fseek(file, address, SEEK_SET) == 0 && fread(data, 1, length, file) != length)
+      memset(data, 0xFF, length);
+    fclose(file);
+  }
+
+  bool write(uint16_t address, const uint8_t *data, uint8_t length)
+  {
+    if (failWrites || address + length > _length)
+      return false;
+    if (_pageSize != 0)
+    {
+      uint8_t current[256];
+      read(address, current, length);
+      for (uint8_t i = 0; i < length; i++)
+        if (current[i] != 0xFF)
+          return false; //programming a byte that is not erased
+    }
+    FILE *file = fopen(_path, "r+b");
+    if (file == NULL)
+      return false;
+    bool good = fseek(file, address, SEEK_SET) == 0 && fwrite(data, 1, length, file) == length;
+    fclose(file);
+    for (uint8_t i = 0; i < length; i++)
+      byteWrites[address + i]++;
+    return good;
+  }
+
+  uint16_t pageSize(void) { return _pageSize; }
+
+  bool erase(uint16_t address)
+  {
+    if (address % _pageSize != 0 || address + _pageSize > _length)
+      return false;
+    erases++;
+    FILE *file = fopen(_path, "r+b");
+    if (file == NULL)
+      return false;
+    bool good = fseek(file, address, SEEK_SET) == 0;
+    for (uint16_t i = 0; good && i < _pageSize; i++)
+      good = fputc(0xFF, file) != EOF;
+    fclose(file);
+    return good;
+  }
+
+private:
+  const char *_path;
+  uint16_t _length;
+  uint16_t _pageSize;
+
+  bool _fill(uint8_t value)
+  {
+    FILE *file = fopen(_path, "wb");
+    if (file == NULL)
+      return false;
+    for (uint16_t i = 0; i < _length; i++)
+      fputc(value, file);
+    fclose(file);
+    return true;
+  }
+};
+
+#endif
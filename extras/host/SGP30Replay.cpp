@@ -0,0 +1,156 @@
+/*
+  Replay of a bus trace for the host build, see SGP30Replay.h
+*/
+
+#include "SGP30Replay.h"
+
+SGP30TraceReader::SGP30TraceReader()
+{
+  begin(NULL, 0);
+}
+
+bool SGP30TraceReader::begin(const uint8_t *trace, size_t size)
+{
+  _trace = trace;
+  _size = size;
+  _position = 0;
+  _time = 0;
+  _truncated = false;
+  start = 0;
+  if (trace == NULL || size < SGP30_TRACE_HEADER || trace[0] != 'S' || trace[1] != 'G' || trace[2] != 'T' ||
+      trace[3] != SGP30_TRACE_VERSION)
+  {
+    _size = 0;
+    return false;
+  }
+  start = (uint32_t)trace[4] | (uint32_t)trace[5] << 8 | (uint32_t)trace[6] << 16 | (uint32_t)trace[7] << 24;
+  _time = start;
+  _position = SGP30_TRACE_HEADER;
+  return true;
+}
+
+bool SGP30TraceReader::next(SGP30TraceRecord &record)
+{
+  if (_truncated || _position >= _size)
+    return false;
+  size_t at = _position;
+  uint8_t tag = _trace[at++];
+  uint32_t elapsed = 0;
+  for (uint8_t shift = 0;; shift += 7)
+  {
+    if (at >= _size || shift > 28)
+    {
+      _truncated = true;
+      return false;
+    }
+    uint8_t byte = _trace[at++];
+    elapsed |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      break;
+  }
+  record.address = SGP30_TRACE_DEFAULT_ADDRESS;
+  if (tag & SGP30_TRACE_ADDRESS)
+  {
+    if (at >= _size)
+    {
+      _truncated = true;
+      return false;
+    }
+    record.address = _trace[at++];
+  }
+  record.length = tag & SGP30_TRACE_LENGTH;
+  if (record.length == SGP30_TRACE_LENGTH)
+  {
+    if (at >= _size)
+    {
+      _truncated = true;
+      return false;
+    }
+    record.length = _trace[at++];
+  }
+  record.read = tag & SGP30_TRACE_READ;
+  record.failed = tag & SGP30_TRACE_FAILED;
+  record.data = NULL;
+  if (!(record.read && record.failed))
+  {
+    if (_size - at < record.length)
+    {
+      _truncated = true;
+      return false;
+    }
+    record.data = _trace + at;
+    at += record.length;
+  }
+  _time += elapsed;
+  record.time = _time;
+  _position = at;
+  return true;
+}
+
+SGP30Replay::SGP30Replay()
+{
+  transactions = 0;
+  diverged = false;
+  divergedAt = 0;
+  memset(&expected, 0, sizeof(expected));
+  _haveNext = false;
+}
+
+bool SGP30Replay::begin(const uint8_t *trace, size_t size)
+{
+  transactions = 0;
+  diverged = false;
+  divergedAt = 0;
+  memset(&expected, 0, sizeof(expected));
+  bool valid = _reader.begin(trace, size);
+  _haveNext = valid && _reader.next(_next);
+  if (valid)
+    hostSetMicros((uint64_t)_reader.start * 1000);
+  return valid;
+}
+
+bool SGP30Replay::finished(void)
+{
+  return !_haveNext && !diverged;
+}
+
+bool SGP30Replay::_take(uint8_t address, bool read, uint8_t length, const uint8_t *data)
+{
+  if (diverged)
+    return false;
+  bool match = _haveNext && _next.address == address && _next.read == read && _next.length == length &&
+               (read || memcmp(_next.data, data, length) == 0);
+  if (!match)
+  {
+    diverged = true;
+    divergedAt = transactions;
+    if (_haveNext)
+      expected = _next;
+    return false;
+  }
+  //The record was taken when the transaction ended, never go back in time
+  if (_next.time * 1000 > hostMicros())
+    hostSetMicros(_next.time * 1000);
+  transactions++;
+  return true;
+}
+
+bool SGP30Replay::write(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  if (!_take(address, false, length, data))
+    return false;
+  bool ok = !_next.failed;
+  _haveNext = _reader.next(_next);
+  return ok;
+}
+
+bool SGP30Replay::read(uint8_t address, uint8_t *data, uint8_t length)
+{
+  if (!_take(address, true, length, NULL))
+    return false;
+  bool ok = !_next.failed;
+  if (ok)
+    memcpy(data, _next.data, length);
+  _haveNext = _reader.next(_next);
+  return ok;
+}
@@ -0,0 +1,94 @@
+/*
+  Replay of a bus trace (SparkFun_SGP30_Trace.h) for the host build.
+
+  SGP30TraceReader walks the records of a trace held in memory.
+  SGP30Replay is a transport that answers the driver from a trace instead
+  of a device: every write must match the next recorded write, byte for
+  byte, and every read gets the recorded bytes, or fails if the recorded
+  one did. The simulated clock is moved forward to each record's time, so
+  millis() inside the driver reads what it did when the trace was taken,
+  and the same calls on an unmodified driver give the same results, as
+  fast as the host can run them. When the driver does something the trace
+  doesn't hold, the replay has diverged and every transaction fails from
+  there on.
+*/
+
+#ifndef SGP30Replay_h
+#define SGP30Replay_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_Transport.h"
+#include "SparkFun_SGP30_Trace.h"
+
+struct SGP30TraceRecord
+{
+  uint64_t time;       //ms on the recorder's millis(), without the rollover
+  uint8_t address;
+  bool read;
+  bool failed;
+  uint8_t length;      //bytes written, or asked for by a read
+  const uint8_t *data; //bytes written or received, NULL for a failed read
+};
+
+class SGP30TraceReader
+{
+public:
+  //millis() when the trace was started
+  uint32_t start;
+
+  SGP30TraceReader();
+
+  //Returns false unless the trace starts with a header this reader knows
+  bool begin(const uint8_t *trace, size_t size);
+
+  //Next record, false at the end of the trace
+  bool next(SGP30TraceRecord &record);
+
+  //True once next() stopped at a record cut short
+  bool truncated(void) { return _truncated; }
+
+  //Bytes used so far
+  size_t position(void) { return _position; }
+
+private:
+  const uint8_t *_trace;
+  size_t _size;
+  size_t _position;
+  uint64_t _time;
+  bool _truncated;
+};
+
+class SGP30Replay : public SGP30Transport
+{
+public:
+  //Transactions answered from the trace
+  unsigned long transactions;
+
+  //Set when the driver asked for something the trace doesn't hold, at
+  //transaction divergedAt; expected is the record it should have matched
+  bool diverged;
+  unsigned long divergedAt;
+  SGP30TraceRecord expected;
+
+  SGP30Replay();
+
+  //Starts over on a trace, which must stay in memory, and sets the clock
+  //to the time it was started
+  bool begin(const uint8_t *trace, size_t size);
+
+  //True once every record has been replayed
+  bool finished(void);
+
+  bool write(uint8_t address, const uint8_t *data, uint8_t length);
+  bool read(uint8_t address, uint8_t *data, uint8_t length);
+
+private:
+  SGP30TraceReader _reader;
+  SGP30TraceRecord _next;
+  bool _haveNext;
+
+  //Takes the next record if it is the transaction asked for
+  bool _take(uint8_t address, bool read, uint8_t length, const uint8_t *data);
+};
+
+#endif
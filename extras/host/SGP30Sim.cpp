@@ -0,0 +1,309 @@
+/*
+  In-memory model of an SGP30 (and a TCA9548A mux) for the host build.
+  See SGP30Sim.h.
+*/
+
+#include "SGP30Sim.h"
+
+//Command words, kept separate from the driver's constants on purpose
+#define SIM_INIT_AIR_QUALITY 0x2003
+#define SIM_MEASURE_AIR_QUALITY 0x2008
+#define SIM_GET_BASELINE 0x2015
+#define SIM_SET_BASELINE 0x201E
+#define SIM_SET_HUMIDITY 0x2061
+#define SIM_MEASURE_TEST 0x2032
+#define SIM_GET_FEATURE_SET_VERSION 0x202F
+#define SIM_GET_SERIAL_ID 0x3682
+#define SIM_MEASURE_RAW_SIGNALS 0x2050
+#define SIM_GET_TVOC_INCEPTIVE_BASELINE 0x20B3 //feature set 0x21 and later
+#define SIM_SET_TVOC_BASELINE 0x2077           //feature set 0x21 and later
+
+//Maximum execution times from the datasheet, in microseconds
+static const uint16_t simCommands[] = {
+    SIM_INIT_AIR_QUALITY, SIM_MEASURE_AIR_QUALITY, SIM_GET_BASELINE, SIM_SET_BASELINE, SIM_SET_HUMIDITY,
+    SIM_MEASURE_TEST, SIM_GET_FEATURE_SET_VERSION, SIM_GET_SERIAL_ID, SIM_MEASURE_RAW_SIGNALS,
+    SIM_GET_TVOC_INCEPTIVE_BASELINE, SIM_SET_TVOC_BASELINE};
+static const uint32_t simLatency[] = {10000, 12000, 10000, 10000, 10000, 220000, 2000, 500, 25000, 10000, 10000};
+#define SIM_COMMAND_COUNT (sizeof(simCommands) / sizeof(simCommands[0]))
+
+SGP30Sim::SGP30Sim()
+{
+  CO2 = 400;
+  TVOC = 0;
+  H2 = 13600;
+  ethanol = 18200;
+  baselineCO2 = 0x8A3C;
+  baselineTVOC = 0x8E12;
+  humidity = 0x0F80;
+  featureSetVersion = 0x0020;
+  inceptiveBaselineTVOC = 0x9A41;
+  selfTestResult = 0xD400;
+  serialID = 0x00000123B7A5ULL;
+  nackWrites = 0;
+  nackReads = 0;
+  nackInits = 0;
+  shortReads = 0;
+  badCRCs = 0;
+  commands = 0;
+  rejected = 0;
+  for (uint8_t i = 0; i < SIM_COMMAND_COUNT; i++)
+  {
+    _latency[i].command = simCommands[i];
+    _latency[i].us = simLatency[i];
+  }
+  reset();
+}
+
+void SGP30Sim::reset(void)
+{
+  _initialized = false;
+  _initTime = 0;
+  _readyAt = 0;
+  _resultWords = 0;
+}
+
+void SGP30Sim::setLatency(uint16_t command, uint32_t us)
+{
+  for (uint8_t i = 0; i < SIM_COMMAND_COUNT; i++)
+    if (_latency[i].command == command)
+      _latency[i].us = us ? us : simLatency[i];
+}
+
+uint8_t SGP30Sim::crc(uint16_t word)
+{
+  uint8_t crc = 0xFF;
+  for (int8_t shift = 8; shift >= 0; shift -= 8)
+  {
+    crc ^= (uint8_t)(word >> shift);
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+bool SGP30Sim::onWrite(const uint8_t *data, size_t length)
+{
+  //The chip does not acknowledge while it is busy with a command
+  if (hostMicros() < _readyAt)
+    return false;
+  if (nackWrites)
+  {
+    nackWrites--;
+    return false;
+  }
+  if (length < 2)
+    return length == 0; //address probe
+  uint16_t command = (uint16_t)(data[0] << 8) | data[1];
+  if (command == SIM_INIT_AIR_QUALITY && nackInits)
+  {
+    nackInits--;
+    return false;
+  }
+  uint16_t words[3];
+  //Older feature sets don't know the inceptive baseline commands
+  if ((command == SIM_GET_TVOC_INCEPTIVE_BASELINE || command == SIM_SET_TVOC_BASELINE) &&
+      (uint8_t)featureSetVersion < 0x21)
+    command = 0;
+  commands++;
+  _resultWords = 0;
+  switch (command)
+  {
+  case SIM_INIT_AIR_QUALITY:
+    _initialized = true;
+    _initTime = hostMicros();
+    _respond(command, NULL, 0);
+    break;
+  case SIM_MEASURE_AIR_QUALITY:
+    //Fixed output for the first 15 seconds after init
+    if (!_initialized || hostMicros() - _initTime < 15000000ULL)
+    {
+      words[0] = 400;
+      words[1] = 0;
+    }
+    else
+    {
+      words[0] = CO2;
+      words[1] = TVOC;
+    }
+    _respond(command, words, 2);
+    break;
+  case SIM_GET_BASELINE:
+    words[0] = baselineCO2;
+    words[1] = baselineTVOC;
+    _respond(command, words, 2);
+    break;
+  case SIM_SET_BASELINE:
+    //Parameters are TVOC baseline then CO2 baseline
+    if (!_param(data, length, 0, &words[0]) || !_param(data, length, 1, &words[1]))
+    {
+      rejected++;
+      return false;
+    }
+    baselineTVOC = words[0];
+    baselineCO2 = words[1];
+    _respond(command, NULL, 0);
+    break;
+  case SIM_SET_HUMIDITY:
+    if (!_param(data, length, 0, &words[0]))
+    {
+      rejected++;
+      return false;
+    }
+    humidity = words[0];
+    _respond(command, NULL, 0);
+    break;
+  case SIM_MEASURE_TEST:
+    _initialized = false; //ends air quality mode, init_air_quality is needed again
+    words[0] = selfTestResult;
+    _respond(command, words, 1);
+    break;
+  case SIM_GET_FEATURE_SET_VERSION:
+    words[0] = featureSetVersion;
+    _respond(command, words, 1);
+    break;
+  case SIM_GET_SERIAL_ID:
+    words[0] = (uint16_t)(serialID >> 32);
+    words[1] = (uint16_t)(serialID >> 16);
+    words[2] = (uint16_t)serialID;
+    _respond(command, words, 3);
+    break;
+  case SIM_MEASURE_RAW_SIGNALS:
+    words[0] = H2;
+    words[1] = ethanol;
+    _respond(command, words, 2);
+    break;
+  case SIM_GET_TVOC_INCEPTIVE_BASELINE:
+    words[0] = inceptiveBaselineTVOC;
+    _respond(command, words, 1);
+    break;
+  case SIM_SET_TVOC_BASELINE:
+    if (!_param(data, length, 0, &words[0]))
+    {
+      rejected++;
+      return false;
+    }
+    baselineTVOC = words[0];
+    _respond(command, NULL, 0);
+    break;
+  default:
+    commands--;
+    rejected++;
+    return false;
+  }
+  return true;
+}
+
+size_t SGP30Sim::onRead(uint8_t *data, size_t length)
+{
+  if (hostMicros() < _readyAt || _resultWords == 0)
+    return 0;
+  if (nackReads)
+  {
+    nackReads--;
+    return 0;
+  }
+  size_t count = 0;
+  for (uint8_t i = 0; i < _resultWords && count + 3 <= length; i++)
+  {
+    data[count++] = (uint8_t)(_result[i] >> 8);
+    data[count++] = (uint8_t)_result[i];
+    data[count++] = crc(_result[i]);
+  }
+  if (count > 0 && badCRCs)
+  {
+    badCRCs--;
+    data[count - 1] ^= 0x5A;
+  }
+  if (count > 0 && shortReads)
+  {
+    shortReads--;
+    count--;
+  }
+  _resultWords = 0; //result can only be read once
+  return count;
+}
+
+void SGP30Sim::onGeneralCall(uint8_t command)
+{
+  if (command == 0x06)
+    reset();
+}
+
+uint32_t SGP30Sim::_latencyOf(uint16_t command)
+{
+  for (uint8_t i = 0; i < SIM_COMMAND_COUNT; i++)
+    if (_latency[i].command == command)
+      return _latency[i].us;
+  return 0;
+}
+
+void SGP30Sim::_respond(uint16_t command, const uint16_t *words, uint8_t count)
+{
+  _readyAt = hostMicros() + _latencyOf(command);
+  for (uint8_t i = 0; i < count; i++)
+    _result[i] = words[i];
+  _resultWords = count;
+}
+
+//Decodes the index'th parameter word after the command, checking its CRC
+bool SGP30Sim::_param(const uint8_t *data, size_t length, uint8_t index, uint16_t *word)
+{
+  size_t offset = 2 + 3 * (size_t)index;
+  if (offset + 3 > length)
+    return false;
+  *word = (uint16_t)(data[offset] << 8) | data[offset + 1];
+  return crc(*word) == data[offset + 2];
+}
+
+TCA9548ASim::TCA9548ASim()
+{
+  mask = 0;
+  selects = 0;
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    _channels[i].address = 0;
+    _channels[i].device = NULL;
+  }
+}
+
+void TCA9548ASim::attach(uint8_t channel, uint8_t address, HostI2CDevice *device)
+{
+  if (channel < 8)
+  {
+    _channels[channel].address = address;
+    _channels[channel].device = device;
+  }
+}
+
+bool TCA9548ASim::onWrite(const uint8_t *data, size_t length)
+{
+  if (length > 0)
+  {
+    mask = data[0];
+    selects++;
+  }
+  return true;
+}
+
+size_t TCA9548ASim::onRead(uint8_t *data, size_t length)
+{
+  if (length == 0)
+    return 0;
+  data[0] = mask;
+  return 1;
+}
+
+HostI2CDevice *TCA9548ASim::route(uint8_t address)
+{
+  for (uint8_t i = 0; i < 8; i++)
+    if ((mask & (1 << i)) && _channels[i].device != NULL && _channels[i].address == address)
+      return _channels[i].device;
+  return NULL;
+}
+
+void TCA9548ASim::onGeneralCall(uint8_t command)
+{
+  for (uint8_t i = 0; i < 8; i++)
+    if ((mask & (1 << i)) && _channels[i].device != NULL)
+      _channels[i].device->onGeneralCall(command);
+}
@@ -0,0 +1,105 @@
+/*
+  In-memory model of an SGP30 (and a TCA9548A mux) for the host build.
+
+  The model decodes every command in SparkFun_SGP30_Arduino_Library.h,
+  answers with correctly CRC'd words and NACKs reads until the command's
+  latency has passed on the simulated clock, like the real chip does.
+  Faults can be injected to exercise the driver's error paths.
+*/
+
+#ifndef SGP30Sim_h
+#define SGP30Sim_h
+
+#include "Arduino.h"
+#include "Wire.h"
+
+class SGP30Sim : public HostI2CDevice
+{
+public:
+  //Values returned by the model, change them at any time
+  uint16_t CO2;
+  uint16_t TVOC;
+  uint16_t H2;
+  uint16_t ethanol;
+  uint16_t baselineCO2;
+  uint16_t baselineTVOC;
+  uint16_t humidity;          //last value written with set_humidity
+  uint16_t featureSetVersion; //0x0020 has no inceptive baseline commands, 0x0022 does
+  uint16_t inceptiveBaselineTVOC;
+  uint16_t selfTestResult;    //0xD400 is a pass
+  uint64_t serialID;          //48 bits
+
+  //Fault injection, each counts down once per affected transaction
+  uint16_t nackWrites; //next command writes are not acknowledged
+  uint16_t nackReads;  //next reads are not acknowledged
+  uint16_t nackInits;  //next init_air_quality commands are not acknowledged
+  uint16_t shortReads; //next reads stop one byte early
+  uint16_t badCRCs;    //next reads return a corrupted checksum
+
+  //Number of commands decoded, and command words rejected for bad CRC or length
+  unsigned long commands;
+  unsigned long rejected;
+
+  SGP30Sim();
+
+  //Back to power up state, fields set above are kept
+  void reset(void);
+
+  //Time from command to result in microseconds, 0 restores the datasheet value
+  void setLatency(uint16_t command, uint32_t us);
+
+  //True after init_air_quality until a reset
+  bool initialized(void) { return _initialized; }
+
+  //CRC-8 as described in the datasheet, x^8+x^5+x^4+1, init 0xFF
+  static uint8_t crc(uint16_t word);
+
+  //HostI2CDevice
+  bool onWrite(const uint8_t *data, size_t length);
+  size_t onRead(uint8_t *data, size_t length);
+  void onGeneralCall(uint8_t command);
+
+private:
+  struct Latency
+  {
+    uint16_t command;
+    uint32_t us;
+  };
+  Latency _latency[12];
+
+  bool _initialized;
+  uint64_t _initTime;
+  uint64_t _readyAt;
+  uint16_t _result[3];
+  uint8_t _resultWords;
+
+  uint32_t _latencyOf(uint16_t command);
+  void _respond(uint16_t command, const uint16_t *words, uint8_t count);
+  bool _param(const uint8_t *data, size_t length, uint8_t index, uint16_t *word);
+};
+
+//TCA9548A style I2C multiplexer, devices on closed channels are unreachable
+class TCA9548ASim : public HostI2CDevice
+{
+public:
+  uint8_t mask;            //open channels
+  unsigned long selects;   //channel writes received
+
+  TCA9548ASim();
+  void attach(uint8_t channel, uint8_t address, HostI2CDevice *device);
+
+  bool onWrite(const uint8_t *data, size_t length);
+  size_t onRead(uint8_t *data, size_t length);
+  HostI2CDevice *route(uint8_t address);
+  void onGeneralCall(uint8_t command);
+
+private:
+  struct Slot
+  {
+    uint8_t address;
+    HostI2CDevice *device;
+  };
+  Slot _channels[8];
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*
+  Host (Linux) stand-in for the Arduino Wire library.
+
+  TwoWire routes transactions to HostI2CDevice models attached to it and
+  keeps a tally of the traffic. Every transaction advances the simulated
+  clock by the time it would take on a real bus at the configured clock
+  speed (9 bits per byte including ACK, plus start and stop).
+*/
+
+#ifndef Host_Wire_h
+#define Host_Wire_h
+
+#include "Arduino.h"
+
+#define HOST_WIRE_BUFFER_LENGTH 32
+#define HOST_WIRE_MAX_DEVICES 16
+
+//A device model on the fake bus
+class HostI2CDevice
+{
+public:
+  virtual ~HostI2CDevice() {}
+
+  //Master wrote length bytes, return false to NACK
+  virtual bool onWrite(const uint8_t *data, size_t length) = 0;
+
+  //Master reads up to length bytes, return how many were sent (0 = NACK)
+  virtual size_t onRead(uint8_t *data, size_t length) = 0;
+
+  //Devices behind a multiplexer are reached through it
+  //Return the device that answers on address, or NULL
+  virtual HostI2CDevice *route(uint8_t address)
+  {
+    (void)address;
+    return NULL;
+  }
+
+  //General call (address 0x00) broadcast, e.g. 0x06 reset
+  virtual void onGeneralCall(uint8_t command) { (void)command; }
+};
+
+//Traffic counters kept by TwoWire
+struct HostWireStats
+{
+  unsigned long transactions; //address phases put on the bus
+  unsigned long nacks;        //transactions not acknowledged
+  unsigned long bytesWritten; //payload bytes, address bytes not included
+  unsigned long bytesRead;
+  uint64_t busMicros;         //simulated time spent clocking the bus
+};
+
+class TwoWire
+{
+public:
+  TwoWire();
+
+  void begin(void) {}
+  void setClock(uint32_t clock) { _clock = clock; }
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t length);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+  int available(void);
+  int read(void);
+
+  //Host only
+  void attach(uint8_t address, HostI2CDevice *device);
+  void detachAll(void);
+  HostWireStats stats;
+  void resetStats(void);
+
+private:
+  struct Slot
+  {
+    uint8_t address;
+    HostI2CDevice *device;
+  };
+  Slot _devices[HOST_WIRE_MAX_DEVICES];
+  uint8_t _deviceCount;
+  uint32_t _clock;
+
+  uint8_t _txAddress;
+  uint8_t _txBuffer[HOST_WIRE_BUFFER_LENGTH];
+  size_t _txLength;
+
+  uint8_t _rxBuffer[HOST_WIRE_BUFFER_LENGTH];
+  size_t _rxLength;
+  size_t _rxIndex;
+
+  HostI2CDevice *_find(uint8_t address);
+  void _clockBus(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,292 @@
+/*
+  Host check and benchmark of the alert rules (SparkFun_SGP30_Alerts.h).
+
+  Feeds synthetic sample streams to SGP30Alerts and checks when every kind
+  of rule turns on and off: thresholds with hysteresis, debounce, slopes,
+  and rules on signals the sample doesn't carry. Then attaches the rules to
+  the driver measuring the simulated sensor, where a callback must fire
+  during the very measurement that crosses the threshold. Reports the time
+  per reading for 8 rules, next to recomputing the same alerts from a
+  history of readings every time. Exits non-zero if any check fails.
+*/
+
+#include <stdio.h>
+#include <chrono>
+#include "Arduino.h"
+#include "HostCheck.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+//Every state change seen by the callback
+struct Changes
+{
+  unsigned long count;
+  uint8_t rule;
+  bool active;
+  SGP30Sample sample;
+};
+
+static void changed(uint8_t rule, bool active, const SGP30Sample &sample, void *context)
+{
+  Changes *changes = (Changes *)context;
+  changes->count++;
+  changes->rule = rule;
+  changes->active = active;
+  changes->sample = sample;
+}
+
+static SGP30Sample sampleAt(unsigned long timestamp, uint16_t CO2, uint16_t TVOC = 0)
+{
+  SGP30Sample sample;
+  sample.timestamp = timestamp;
+  sample.CO2 = CO2;
+  sample.TVOC = TVOC;
+  sample.H2 = 0;
+  sample.ethanol = 0;
+  return sample;
+}
+
+static void checkThresholds(void)
+{
+  SGP30Alerts<4> alerts;
+  Changes high = {0, 0, false, sampleAt(0, 0)};
+  Changes low = {0, 0, false, sampleAt(0, 0)};
+  CHECK(alerts.addAbove(SGP30_SIGNAL_CO2, 1000, 800, changed, &high) == 0);
+  CHECK(alerts.addBelow(SGP30_SIGNAL_TVOC, 10, 20, changed, &low) == 1);
+  CHECK(alerts.size() == 2 && alerts.capacity() == 4);
+
+  //Up to 1200 and back down, with noise around the thresholds
+  unsigned long t = 0;
+  for (uint16_t CO2 = 400; CO2 < 1200; CO2 += 10)
+    alerts.update(sampleAt(t += 1000, CO2, 100));
+  CHECK(high.count == 1 && high.active && high.sample.CO2 == 1000);
+  CHECK(alerts.active(0));
+  for (int i = 0; i < 50; i++)
+    alerts.update(sampleAt(t += 1000, (i & 1) ? 990 : 810, 100)); //inside the hysteresis
+  CHECK(high.count == 1 && alerts.active(0));
+  alerts.update(sampleAt(t += 1000, 799, 100));
+  CHECK(high.count == 2 && !high.active && high.sample.CO2 == 799);
+  for (int i = 0; i < 50; i++)
+    alerts.update(sampleAt(t += 1000, (i & 1) ? 999 : 801, 100));
+  CHECK(high.count == 2);
+
+  //Below: on at or under set, off over clear
+  alerts.update(sampleAt(t += 1000, 400, 11));
+  CHECK(low.count == 0);
+  alerts.update(sampleAt(t += 1000, 400, 10));
+  CHECK(low.count == 1 && low.active && alerts.active(1));
+  alerts.update(sampleAt(t += 1000, 400, 20));
+  CHECK(low.count == 1);
+  alerts.update(sampleAt(t += 1000, 400, 21));
+  CHECK(low.count == 2 && !low.active);
+
+  //Debounce: spikes shorter than 3 readings are ignored
+  alerts.setDebounce(0, 3);
+  for (int spike = 1; spike <= 2; spike++)
+  {
+    for (int i = 0; i < spike; i++)
+      alerts.update(sampleAt(t += 1000, 1500, 100));
+    alerts.update(sampleAt(t += 1000, 500, 100));
+  }
+  CHECK(high.count == 2 && !alerts.active(0));
+  for (int i = 0; i < 3; i++)
+    alerts.update(sampleAt(t += 1000, 1500, 100));
+  CHECK(high.count == 3 && high.active);
+
+  //Raw signal rules don't see air quality readings
+  alerts.clear();
+  Changes raw = {0, 0, false, sampleAt(0, 0)};
+  alerts.addAbove(SGP30_SIGNAL_H2, 1, 0, changed, &raw);
+  SGP30Sample sample = sampleAt(t += 1000, 400);
+  sample.H2 = 13000;
+  alerts.update(sample, SGP30_HISTORY_AIR_QUALITY);
+  CHECK(raw.count == 0);
+  alerts.update(sample, SGP30_HISTORY_RAW_SIGNALS);
+  CHECK(raw.count == 1);
+  alerts.reset();
+  CHECK(!alerts.active(0) && raw.count == 1);
+
+  //Full
+  SGP30Alerts<1> one;
+  CHECK(one.addAbove(SGP30_SIGNAL_CO2, 1, 0) == 0);
+  CHECK(one.addAbove(SGP30_SIGNAL_CO2, 1, 0) == SGP30_NO_RULE);
+  CHECK(!one.active(5) && one.slope(5) == 0);
+}
+
+static void checkSlopes(void)
+{
+  SGP30Alerts<2> alerts;
+  Changes rising = {0, 0, false, sampleAt(0, 0)};
+  Changes falling = {0, 0, false, sampleAt(0, 0)};
+  CHECK(alerts.addRising(SGP30_SIGNAL_CO2, 50, 20, 60000, changed, &rising) == 0);
+  CHECK(alerts.addFalling(SGP30_SIGNAL_CO2, 50, 20, 60000, changed, &falling) == 1);
+
+  //Flat, then 1 ppm per second = 60 ppm per minute, sampled every second
+  unsigned long t = 0;
+  uint16_t CO2 = 600;
+  for (int i = 0; i < 300; i++)
+    alerts.update(sampleAt(t += 1000, CO2));
+  CHECK(alerts.slope(0) == 0 && rising.count == 0 && falling.count == 0);
+  unsigned long start = t;
+  while (rising.count == 0 && t - start < 600000)
+    alerts.update(sampleAt(t += 1000, ++CO2));
+  //An average over a 1 minute window passes 50 of 60 after about 1.8 windows
+  printf("rising 60 ppm/min: alert after %lu s\n", (t - start) / 1000);
+  CHECK(rising.count == 1 && rising.active);
+  CHECK(t - start >= 90000 && t - start <= 130000);
+  for (int i = 0; i < 600; i++)
+    alerts.update(sampleAt(t += 1000, ++CO2));
+  CHECK(alerts.slope(0) >= 59 && alerts.slope(0) <= 60);
+  CHECK(alerts.slope(1) == alerts.slope(0));
+
+  //Steady again: off once the average drops under 20
+  start = t;
+  while (rising.active && t - start < 600000)
+    alerts.update(sampleAt(t += 1000, CO2));
+  CHECK(rising.count == 2 && !rising.active);
+  CHECK(falling.count == 0);
+
+  //Falling, with a reading missing now and then
+  for (int i = 0; i < 300; i++)
+  {
+    t += 1000;
+    CO2 -= 2;
+    if (i % 7 != 3)
+      alerts.update(sampleAt(t, CO2));
+  }
+  CHECK(falling.count == 1 && falling.active);
+  CHECK(alerts.slope(1) >= -122 && alerts.slope(1) <= -118);
+
+  //A gap longer than the window starts the average over from the rate across the gap
+  alerts.update(sampleAt(t += 120000, CO2 -= 240));
+  CHECK(alerts.slope(1) == -120);
+}
+
+//The callback runs inside the measurement that crosses the threshold
+static SGP30 *driven;
+static uint16_t seenCO2;
+
+static void ventilate(uint8_t rule, bool active, const SGP30Sample &sample, void *context)
+{
+  (void)rule;
+  (void)context;
+  if (active)
+    seenCO2 = driven->CO2; //already published
+  (void)sample;
+}
+
+static void checkDriver(void)
+{
+  SGP30Sim sim;
+  Wire.attach(0x58, &sim);
+  SGP30 sensor;
+  driven = &sensor;
+  SGP30Alerts<2> alerts;
+  Changes changes = {0, 0, false, sampleAt(0, 0)};
+  alerts.addAbove(SGP30_SIGNAL_CO2, 1000, 800, ventilate);
+  alerts.addRising(SGP30_SIGNAL_TVOC, 100, 10, 30000, changed, &changes);
+  sensor.attachAlerts(alerts);
+  CHECK(sensor.begin(Wire));
+  sensor.initAirQuality();
+  delay(15000);
+
+  unsigned long crossedAt = 0;
+  for (uint16_t i = 0; i < 120; i++)
+  {
+    sim.CO2 = 900 + i * 2;
+    sim.TVOC = i < 60 ? 50 : 50 + (i - 60) * 10; //600 ppb per minute after a minute
+    unsigned long before = millis();
+    CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+    if (seenCO2 != 0 && crossedAt == 0)
+      crossedAt = before;
+    delay(1000 - 12);
+  }
+  CHECK(seenCO2 == 1000);
+  CHECK(crossedAt != 0);
+  CHECK(changes.count == 1 && changes.active && changes.sample.TVOC > 50);
+  CHECK(alerts.active(0) && alerts.active(1));
+  //Raw signal readings leave the air quality rules alone
+  CHECK(sensor.measureRawSignals() == SGP30_SUCCESS);
+  CHECK(changes.count == 1);
+  sensor.detachAlerts(alerts);
+  sim.CO2 = 400;
+  sensor.measureAirQuality();
+  CHECK(alerts.active(0));
+  Wire.detachAll();
+}
+
+static volatile int sink;
+
+//Same alerts recomputed from the last minute of readings on every tick
+static int recompute(const SGP30Sample *history, uint16_t count)
+{
+  int alerts = 0;
+  for (int rule = 0; rule < 8; rule++)
+  {
+    uint8_t signal = rule & 3;
+    //Least squares slope over the window
+    double n = count, st = 0, sv = 0, stt = 0, stv = 0;
+    for (uint16_t i = 0; i < count; i++)
+    {
+      const SGP30Sample &s = history[i];
+      double v = signal == 0 ? s.CO2 : signal == 1 ? s.TVOC : signal == 2 ? s.H2 : s.ethanol;
+      double t = s.timestamp / 60000.0;
+      st += t;
+      sv += v;
+      stt += t * t;
+      stv += t * v;
+    }
+    double slope = (n * stv - st * sv) / (n * stt - st * st);
+    if (rule < 4 ? sv / n > 1000 : slope > 50)
+      alerts++;
+  }
+  return alerts;
+}
+
+static void benchmark(void)
+{
+  SGP30Alerts<8> alerts;
+  for (uint8_t signal = 0; signal < 4; signal++)
+  {
+    alerts.addAbove((SGP30SIGNAL)signal, 1000, 800);
+    alerts.addRising((SGP30SIGNAL)signal, 50, 20, 60000);
+  }
+  const int iterations = 1000000;
+  SGP30Sample sample = sampleAt(0, 0);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    sample.timestamp += 1000;
+    sample.CO2 = 400 + (i & 1023);
+    sample.TVOC = (uint16_t)(i * 7);
+    sample.H2 = 13000 + (i & 255);
+    sample.ethanol = 18000 - (i & 255);
+    alerts.update(sample);
+  }
+  double rulesNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+  sink = alerts.active(0);
+
+  static SGP30Sample history[60];
+  for (int i = 0; i < 60; i++)
+    history[i] = sampleAt(i * 1000, 400 + i * 10, i);
+  const int recomputes = 100000;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < recomputes; i++)
+  {
+    history[i % 60].CO2 = 400 + (i & 1023);
+    sink = recompute(history, 60);
+  }
+  double recomputeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / recomputes;
+  printf("8 rules per reading: %.1f ns incremental, %.1f ns recomputed over 60 readings\n", rulesNs, recomputeNs);
+  printf("SGP30Alerts<8>: %zu bytes\n", sizeof(SGP30Alerts<8>));
+}
+
+int main(void)
+{
+  checkThresholds();
+  checkSlopes();
+  checkDriver();
+  benchmark();
+  return checkSummary();
+}
@@ -0,0 +1,138 @@
+/*
+  Host check of the compile time configurations (SparkFun_SGP30_Basic.h).
+
+  Runs BasicSGP30 with no features and with every feature against the
+  simulated SGP30, next to the full SGP30 driver, and checks that they all
+  read the same values and report errors the same way. Then prints the RAM
+  each configuration takes per sensor (sizeof) on this host; make sizes
+  reports their flash. Exits non-zero if any check fails.
+*/
+
+#include <stdio.h>
+#include <type_traits>
+#include "Arduino.h"
+#include "HostCheck.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_Basic.h"
+
+static SGP30Sim sim;
+
+//What every configuration has, works on BasicSGP30<...> and SGP30 alike
+template <class Sensor>
+static void checkAirQuality(Sensor &sensor)
+{
+  sim.reset();
+  CHECK(sensor.begin(Wire));
+  sensor.initAirQuality();
+  delay(15000); //CO2=400 and TVOC=0 for the first 15 seconds
+  sim.CO2 = 1234;
+  sim.TVOC = 56;
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.CO2 == 1234 && sensor.TVOC == 56);
+
+  //Split phase
+  sim.CO2 = 600;
+  CHECK(sensor.startAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.isBusy() && !sensor.isReady());
+  CHECK(sensor.readAirQuality() == SGP30_ERR_NOT_READY);
+  while (!sensor.isReady())
+    delay(sensor.msUntilReady());
+  CHECK(sensor.readAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.CO2 == 600 && !sensor.isBusy());
+
+  //Failed reads leave the results alone
+  sim.badCRCs = 1;
+  sim.CO2 = 700;
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_BAD_CRC);
+  CHECK(sensor.CO2 == 600);
+  sim.nackReads = 10;
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  sim.nackReads = 0;
+  CHECK(sensor.CO2 == 600);
+}
+
+template <class Sensor>
+static void checkFeatures(Sensor &sensor)
+{
+  sim.H2 = 13000;
+  sim.ethanol = 18000;
+  CHECK(sensor.measureRawSignals() == SGP30_SUCCESS);
+  CHECK(sensor.H2 == 13000 && sensor.ethanol == 18000);
+  sim.H2 = 13100;
+  CHECK(sensor.startRawSignals() == SGP30_SUCCESS);
+  delay(26);
+  CHECK(sensor.readRawSignals() == SGP30_SUCCESS);
+  CHECK(sensor.H2 == 13100);
+
+  CHECK(sensor.getSerialID() == SGP30_SUCCESS);
+  CHECK(sensor.serialID == sim.serialID);
+  CHECK(sensor.getFeatureSetVersion() == SGP30_SUCCESS);
+  CHECK(sensor.featureSetVersion == sim.featureSetVersion);
+
+  CHECK(sensor.measureTest() == SGP30_SUCCESS);
+  sim.selfTestResult = 0x1234;
+  CHECK(sensor.measureTest() == SGP30_SELF_TEST_FAIL);
+  sim.selfTestResult = 0xD400;
+  CHECK(sensor.startTest() == SGP30_SUCCESS);
+  delay(221);
+  CHECK(sensor.readTest() == SGP30_SUCCESS);
+
+  sensor.setBaseline(0x8F00, 0x9100);
+  delay(10);
+  CHECK(sim.baselineCO2 == 0x8F00 && sim.baselineTVOC == 0x9100);
+  CHECK(sensor.getBaseline() == SGP30_SUCCESS);
+  CHECK(sensor.baselineCO2 == 0x8F00 && sensor.baselineTVOC == 0x9100);
+
+  //25C 50%RH, then a change inside the default hysteresis
+  CHECK(sensor.setRelativeHumidity(2500, 5000));
+  delay(10);
+  CHECK(sim.humidity == sgp30AbsoluteHumidity(2500, 5000));
+  CHECK(!sensor.setRelativeHumidity(2500, 5010));
+  sensor.generalCallReset();
+  delay(1);
+  CHECK(sensor.setRelativeHumidity(2500, 5010)); //compensation was lost with the reset
+  delay(10);
+}
+
+int main(void)
+{
+  Wire.attach(0x58, &sim);
+
+  BasicSGP30<> minimal;
+  checkAirQuality(minimal);
+
+  BasicSGP30<SGP30_ALL_FEATURES> full;
+  checkAirQuality(full);
+  checkFeatures(full);
+
+  SGP30 driver;
+  checkAirQuality(driver);
+  checkFeatures(driver);
+
+  //No sensor
+  Wire.detachAll();
+  CHECK(!minimal.begin(Wire));
+  CHECK(!full.begin(Wire));
+
+  printf("%-44s %6s\n", "configuration", "bytes");
+  printf("%-44s %6zu\n", "BasicSGP30<>", sizeof(BasicSGP30<>));
+  printf("%-44s %6zu\n", "BasicSGP30<SGP30RawSignals>", sizeof(BasicSGP30<SGP30RawSignals>));
+  printf("%-44s %6zu\n", "BasicSGP30<SGP30SerialID>", sizeof(BasicSGP30<SGP30SerialID>));
+  printf("%-44s %6zu\n", "BasicSGP30<SGP30FeatureSet>", sizeof(BasicSGP30<SGP30FeatureSet>));
+  printf("%-44s %6zu\n", "BasicSGP30<SGP30SelfTest>", sizeof(BasicSGP30<SGP30SelfTest>));
+  printf("%-44s %6zu\n", "BasicSGP30<SGP30Baselines>", sizeof(BasicSGP30<SGP30Baselines>));
+  printf("%-44s %6zu\n", "BasicSGP30<SGP30HumidityCompensation>", sizeof(BasicSGP30<SGP30HumidityCompensation>));
+  printf("%-44s %6zu\n", "BasicSGP30<SGP30_ALL_FEATURES>", sizeof(BasicSGP30<SGP30_ALL_FEATURES>));
+  printf("%-44s %6zu\n", "SGP30", sizeof(SGP30));
+  //A feature left out takes no room
+  CHECK(sizeof(BasicSGP30<>) == sizeof(SGP30Core));
+  CHECK(sizeof(BasicSGP30<SGP30SelfTest>) == sizeof(SGP30Core));
+  CHECK(sizeof(BasicSGP30<>) < sizeof(BasicSGP30<SGP30_ALL_FEATURES>));
+  CHECK(sizeof(BasicSGP30<SGP30_ALL_FEATURES>) < sizeof(SGP30));
+  //The full driver runs the same command code, with its hooks on top
+  CHECK((std::is_base_of<BasicSGP30<SGP30_ALL_FEATURES>, SGP30>::value));
+
+  return checkSummary();
+}
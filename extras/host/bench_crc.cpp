@@ -0,0 +1,100 @@
+/*
+  Host micro-benchmark for the SGP30 CRC8 kernels.
+
+  Checks that the bitwise, nibble-table and byte-table kernels agree on every
+  16 bit word, then reports cycles (x86 TSC, else nanoseconds) per word CRC
+  and per 9 byte response verify. Code and table sizes come from
+  'make sizes', which can be pointed at a cross compiler, e.g.
+  make sizes SIZE_CXX=avr-g++ SIZE_FLAGS="-mmcu=atmega328p -Os"
+*/
+
+#include <stdio.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t benchNow(void) { return __rdtsc(); }
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t benchNow(void)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+#include "SparkFun_SGP30_CRC.h"
+
+typedef uint8_t (*Kernel)(const uint8_t *data, uint8_t length);
+
+struct KernelInfo
+{
+  const char *name;
+  Kernel kernel;
+};
+
+static const KernelInfo kernels[] = {
+    {"bitwise", sgp30CRC8Bitwise},
+    {"nibble table (16)", sgp30CRC8Nibble},
+    {"byte table (256)", sgp30CRC8Byte},
+};
+
+static volatile uint8_t sink;
+
+int main(void)
+{
+  int failures = 0;
+  //Every kernel against the bitwise reference, for all words
+  for (uint32_t word = 0; word <= 0xFFFF; word++)
+  {
+    uint8_t bytes[2] = {(uint8_t)(word >> 8), (uint8_t)word};
+    uint8_t reference = sgp30CRC8Bitwise(bytes, 2);
+    for (size_t k = 1; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+      if (kernels[k].kernel(bytes, 2) != reference)
+        failures++;
+  }
+  //Example from the datasheet: 0xBEEF -> 0x92
+  if (sgp30CRC8Word(0xBEEF) != 0x92)
+    failures++;
+  //Verify accepts a good serial ID response and rejects a flipped bit
+  uint8_t frame[9] = {0x00, 0x00, 0x81, 0x01, 0x23, 0x54, 0xB7, 0xA5, 0x1F};
+  for (uint8_t i = 0; i < 3; i++)
+    frame[3 * i + 2] = sgp30CRC8Word((uint16_t)(frame[3 * i] << 8 | frame[3 * i + 1]));
+  if (!sgp30VerifyWords(frame, 3))
+    failures++;
+  frame[7] ^= 0x10;
+  if (sgp30VerifyWords(frame, 3))
+    failures++;
+  frame[7] ^= 0x10;
+
+  const uint32_t iterations = 1 << 20;
+  printf("%-20s %14s %14s\n", "kernel", BENCH_UNIT "/word", BENCH_UNIT "/9B verify");
+  for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+  {
+    uint64_t start = benchNow();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+      uint8_t bytes[2] = {(uint8_t)(i >> 8), (uint8_t)i};
+      sink = kernels[k].kernel(bytes, 2);
+    }
+    double perWord = (double)(benchNow() - start) / iterations;
+
+    start = benchNow();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+      frame[0] = (uint8_t)i;
+      bool good = true;
+      for (uint8_t w = 0; w < 3; w++)
+        good &= kernels[k].kernel(&frame[3 * w], 2) == frame[3 * w + 2];
+      sink = good;
+    }
+    double perFrame = (double)(benchNow() - start) / iterations;
+    printf("%-20s %14.1f %14.1f\n", kernels[k].name, perWord, perFrame);
+  }
+
+  if (failures)
+  {
+    printf("%d CRC mismatch(es)\n", failures);
+    return 1;
+  }
+  printf("all kernels agree\n");
+  return 0;
+}
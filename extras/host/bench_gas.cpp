@@ -0,0 +1,112 @@
+/*
+  Host benchmark for the integer gas concentration kernel.
+
+  Compares sgp30GasConcentration() with c_ref * std::exp((s_ref - s) / 512)
+  in double precision for every raw signal value and a range of reference
+  concentrations, reports the worst error and the time per conversion of
+  both, then calibrates s_ref from simulated clean air readings. Exits
+  non-zero if the error bound documented in SparkFun_SGP30_Gas.h is
+  exceeded or the calibration is off.
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <cmath>
+#include "Arduino.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_Gas.h"
+
+static volatile uint32_t sink;
+
+static double reference(uint16_t signal, uint16_t s_ref, uint16_t c_ref)
+{
+  return c_ref * std::exp(((int32_t)s_ref - signal) / 512.0);
+}
+
+int main(void)
+{
+  int failures = 0;
+
+  //Accuracy over every signal value, against the bound 0.01% + 1 count
+  const uint16_t concentrations[] = {1, SGP30_ETHANOL_REFERENCE_PPB, SGP30_H2_REFERENCE_PPB, 10000, 65535};
+  double worstRelative = 0;
+  unsigned long saturated = 0;
+  for (uint8_t c = 0; c < sizeof(concentrations) / sizeof(concentrations[0]); c++)
+  {
+    for (uint32_t signal = 0; signal <= 0xFFFF; signal++)
+    {
+      double exact = reference((uint16_t)signal, SGP30_H2_REFERENCE_SIGNAL, concentrations[c]);
+      uint32_t value = sgp30GasConcentration((uint16_t)signal, SGP30_H2_REFERENCE_SIGNAL, concentrations[c]);
+      if (exact >= 4294967295.0 * (1 - 0.0001))
+      {
+        //Saturated, or close enough to the top that the bound allows it
+        if (exact >= 4294967295.0 && value != 0xFFFFFFFF)
+          failures++;
+        saturated++;
+        continue;
+      }
+      double error = fabs(value - exact);
+      if (exact >= 100000 && error / exact > worstRelative)
+        worstRelative = error / exact;
+      double excess = error - (1 + 0.0001 * exact);
+      if (excess > 0)
+      {
+        if (failures < 10)
+          printf("FAIL: signal %u c_ref %u: %lu vs %.2f\n", signal, concentrations[c], (unsigned long)value, exact);
+        failures++;
+      }
+    }
+  }
+  printf("worst relative error above 100000 counts: %.4f%%, %lu saturated results\n", worstRelative * 100, saturated);
+
+  //Speed over the signal range seen in practice
+  const int iterations = 1000000;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    sink = sgp30GasConcentration((uint16_t)(10000 + i % 8192), SGP30_H2_REFERENCE_SIGNAL, SGP30_H2_REFERENCE_PPB);
+  double integerNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    sink = (uint32_t)(reference((uint16_t)(10000 + i % 8192), SGP30_H2_REFERENCE_SIGNAL, SGP30_H2_REFERENCE_PPB) + 0.5);
+  double doubleNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+  printf("integer: %.1f ns/conversion, std::exp reference: %.1f ns/conversion\n", integerNs, doubleNs);
+
+  //Calibration from a minute of clean air readings
+  SGP30Sim sim;
+  sim.H2 = 13100;
+  sim.ethanol = 18950;
+  Wire.attach(0x58, &sim);
+  SGP30 mySensor;
+  mySensor.begin(Wire);
+  SGP30GasConverter converter;
+  converter.startCalibration(60);
+  bool done = false;
+  for (int s = 0; s < 60; s++)
+  {
+    sim.H2 = (uint16_t)(13100 + (s % 5) - 2);
+    sim.ethanol = (uint16_t)(18950 + (s % 3) - 1);
+    if (mySensor.measureRawSignals() == SGP30_SUCCESS)
+      done = converter.calibrate(mySensor.H2, mySensor.ethanol);
+    delay(1000);
+  }
+  printf("calibrated s_ref: H2 %u, ethanol %u; clean air reads %lu ppb H2, %lu ppb ethanol\n",
+         converter.referenceH2, converter.referenceEthanol,
+         (unsigned long)converter.H2(13100), (unsigned long)converter.ethanol(18950));
+  if (!done || converter.calibrating() || converter.referenceH2 != 13100 || converter.referenceEthanol != 18950 ||
+      converter.H2(13100) != SGP30_H2_REFERENCE_PPB || converter.ethanol(18950) != SGP30_ETHANOL_REFERENCE_PPB ||
+      converter.H2(13100 - 512) != 1359) //e * 500
+  {
+    printf("FAIL: calibration\n");
+    failures++;
+  }
+
+  if (failures)
+  {
+    printf("FAIL: %d check(s) failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+  Host benchmark for the integer humidity compensation.
+
+  Compares sgp30AbsoluteHumidity() with the double precision RHtoAbsolute()
+  and doubleToFixedPoint() from Example3_Humidity over -20C to 70C and
+  0-100% RH, reports the worst error and the time per conversion of both,
+  then counts how many set_humidity writes the hysteresis saves on a slowly
+  drifting humidity signal. Exits non-zero if the error bound documented in
+  SparkFun_SGP30_Humidity.h is exceeded.
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "Arduino.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+//Reference from Example3_Humidity
+static double RHtoAbsolute(float relHumidity, float tempC)
+{
+  double eSat = 6.11 * pow(10.0, (7.5 * tempC / (237.7 + tempC)));
+  double vaporPressure = (relHumidity * eSat) / 100; //millibars
+  double absHumidity = 1000 * vaporPressure * 100 / ((tempC + 273) * 461.5); //Ideal gas law with unit conversions
+  return absHumidity;
+}
+
+static uint16_t doubleToFixedPoint(double number)
+{
+  int power = 1 << 8;
+  double number2 = number * power;
+  uint16_t value = floor(number2 + 0.5);
+  return value;
+}
+
+static volatile uint16_t sink;
+
+int main(void)
+{
+  //Accuracy over the whole table range
+  int worst = 0;
+  int16_t worstT = 0;
+  uint16_t worstRH = 0;
+  for (int32_t t = SGP30_HUMIDITY_MIN_TEMPERATURE; t <= SGP30_HUMIDITY_MAX_TEMPERATURE; t += 5)
+  {
+    for (uint16_t rh = 100; rh <= 10000; rh += 100)
+    {
+      int reference = doubleToFixedPoint(RHtoAbsolute(rh / 100.0f, t / 100.0f));
+      int error = abs((int)sgp30AbsoluteHumidity((int16_t)t, rh) - reference);
+      if (error > worst)
+      {
+        worst = error;
+        worstT = (int16_t)t;
+        worstRH = rh;
+      }
+    }
+  }
+  printf("worst error: %d/256 g/m^3 (%.3f g/m^3) at %.2fC %.2f%%RH\n", worst, worst / 256.0, worstT / 100.0, worstRH / 100.0);
+
+  //Speed, same inputs for both
+  const int iterations = 1000000;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    sink = sgp30AbsoluteHumidity((int16_t)(-2000 + i % 9000), (uint16_t)(i % 10000));
+  double integerNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    sink = doubleToFixedPoint(RHtoAbsolute((i % 10000) / 100.0f, (-2000 + i % 9000) / 100.0f));
+  double doubleNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+  printf("integer: %.1f ns/conversion, double reference: %.1f ns/conversion\n", integerNs, doubleNs);
+
+  //Bus writes saved by the hysteresis: 24 hours of 1 Hz updates from a
+  //humidity sensor with a slow indoor swing and +-0.1C / +-0.3%RH of noise
+  SGP30Sim sim;
+  Wire.attach(0x58, &sim);
+  SGP30 mySensor;
+  mySensor.begin(Wire);
+  unsigned long updates = 0, seconds = 24UL * 3600;
+  uint32_t noise = 12345;
+  for (unsigned long s = 0; s < seconds; s++)
+  {
+    noise = noise * 1103515245 + 12345;
+    int16_t t = 2200 + (int16_t)(150 * sin(s * 2 * M_PI / 86400)) + (int16_t)((noise >> 16) % 21) - 10;
+    uint16_t rh = 4500 + (uint16_t)(500 * sin(s * 2 * M_PI / 43200)) + (uint16_t)((noise >> 8) % 61) - 30;
+    if (mySensor.setRelativeHumidity(t, rh))
+      updates++;
+    delay(1000);
+  }
+  printf("set_humidity writes over 24 h: %lu of %lu updates (hysteresis 16/256 g/m^3)\n", updates, seconds);
+
+  if (worst > 18)
+  {
+    printf("FAIL: error above the documented 18/256 g/m^3\n");
+    return 1;
+  }
+  return 0;
+}
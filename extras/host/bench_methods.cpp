@@ -0,0 +1,972 @@
+/*
+  Host benchmark and regression check for the SGP30 driver.
+
+  Runs every public method against the simulated SGP30 and reports, per call,
+  the bytes moved on the bus, the simulated bus time, the simulated time the
+  call took (bus time plus the driver's waits) and the host CPU time.
+  Afterwards it checks results and error handling against injected faults.
+  Exits non-zero if any check fails, so it can run in CI.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include "Arduino.h"
+#include "HostCheck.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SGP30FileStorage.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_Array.h"
+#include "SparkFun_SGP30_LinuxI2C.h"
+#include "SparkFun_SGP30_Scheduler.h"
+#include "SparkFun_SGP30_Recovery.h"
+#include "SparkFun_SGP30_Health.h"
+
+static SGP30Sim sim;
+static SGP30 mySensor;
+
+//Times iterations calls of body and prints one row of the report
+template <typename Body>
+static void bench(const char *name, unsigned long iterations, Body body)
+{
+  Wire.resetStats();
+  uint64_t simStart = hostMicros();
+  std::chrono::steady_clock::time_point cpuStart = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < iterations; i++)
+    body();
+  double cpuNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - cpuStart).count();
+  uint64_t simUs = hostMicros() - simStart;
+  printf("%-24s %8.1f %8.1f %10.1f %10.1f %10.1f\n", name,
+         (double)(Wire.stats.bytesWritten + Wire.stats.bytesRead) / iterations,
+         (double)Wire.stats.transactions / iterations,
+         (double)Wire.stats.busMicros / iterations,
+         (double)simUs / iterations,
+         cpuNs / iterations);
+}
+
+static void benchmarks(unsigned long n)
+{
+  printf("%-24s %8s %8s %10s %10s %10s\n", "method (per call)", "bytes", "xfers", "bus us", "sim us", "cpu ns");
+  bench("begin", n, [] { mySensor.begin(Wire); });
+  bench("initAirQuality", n, [] { mySensor.initAirQuality(); delay(10); });
+  bench("measureAirQuality", n, [] { mySensor.measureAirQuality(); });
+  bench("start/readAirQuality", n, [] {
+    mySensor.startAirQuality();
+    while (!mySensor.isReady())
+      delay(1);
+    mySensor.readAirQuality();
+  });
+  bench("getBaseline", n, [] { mySensor.getBaseline(); });
+  bench("setBaseline", n, [] { mySensor.setBaseline(0x8A3C, 0x8E12); delay(10); });
+  bench("setHumidity", n, [] { mySensor.setHumidity(0x0F80); delay(10); });
+  bench("getFeatureSetVersion", n, [] { mySensor.getFeatureSetVersion(); });
+  bench("measureRawSignals", n, [] { mySensor.measureRawSignals(); });
+  bench("getSerialID", n, [] { mySensor.getSerialID(); });
+  bench("measureTest", n, [] { mySensor.measureTest(); });
+  bench("generalCallReset", n, [] { mySensor.generalCallReset(); });
+}
+
+static void checkResults(void)
+{
+  sim = SGP30Sim();
+  CHECK(mySensor.begin(Wire));
+  CHECK(mySensor.serialID == sim.serialID);
+
+  mySensor.initAirQuality();
+  delay(10);
+  CHECK(mySensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(mySensor.CO2 == 400 && mySensor.TVOC == 0); //first 15 seconds
+  delay(15000);
+  sim.CO2 = 1234;
+  sim.TVOC = 56;
+  CHECK(mySensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(mySensor.CO2 == 1234 && mySensor.TVOC == 56);
+
+  CHECK(mySensor.setBaseline(0x1111, 0x2222) == SGP30_SUCCESS);
+  delay(10);
+  CHECK(sim.baselineCO2 == 0x1111 && sim.baselineTVOC == 0x2222);
+  CHECK(mySensor.getBaseline() == SGP30_SUCCESS);
+  CHECK(mySensor.baselineCO2 == 0x1111 && mySensor.baselineTVOC == 0x2222);
+
+  CHECK(mySensor.setHumidity(0x0A55) == SGP30_SUCCESS);
+  delay(10);
+  CHECK(sim.humidity == 0x0A55);
+  CHECK(sim.rejected == 0);
+  CHECK(mySensor.setRelativeHumidity(2500, 5000)); //25C 50%, about 11.5 g/m^3
+  delay(10);
+  CHECK(sim.humidity == sgp30AbsoluteHumidity(2500, 5000));
+  CHECK(!mySensor.setRelativeHumidity(2505, 5010)); //inside the hysteresis
+  CHECK(mySensor.setRelativeHumidity(2500, 5500));
+  delay(10);
+  CHECK(sim.humidity == sgp30AbsoluteHumidity(2500, 5500));
+
+  //Writes that were not acknowledged, or would drop an unread result, are
+  //reported and not remembered
+  sim.nackWrites = 1;
+  CHECK(!mySensor.setRelativeHumidity(2500, 6000));
+  CHECK(mySensor.setRelativeHumidity(2505, 6010)); //not inside the hysteresis of a lost write
+  delay(10);
+  CHECK(sim.humidity == sgp30AbsoluteHumidity(2505, 6010));
+  sim.nackWrites = 2;
+  CHECK(mySensor.setHumidity(0x0A00) == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(mySensor.setBaseline(0x3333, 0x4444) == SGP30_ERR_I2C_TIMEOUT);
+  delay(10);
+  CHECK(sim.baselineCO2 == 0x1111 && sim.baselineTVOC == 0x2222);
+  CHECK(mySensor.startAirQuality() == SGP30_SUCCESS);
+  CHECK(mySensor.setHumidity(0x0A00) == SGP30_ERR_BUSY);
+  CHECK(mySensor.setBaseline(0x3333, 0x4444) == SGP30_ERR_BUSY);
+  delay(20);
+  CHECK(mySensor.readAirQuality() == SGP30_SUCCESS);
+  CHECK(sim.humidity == sgp30AbsoluteHumidity(2505, 6010));
+
+  CHECK(mySensor.getFeatureSetVersion() == SGP30_SUCCESS);
+  CHECK(mySensor.featureSetVersion == sim.featureSetVersion);
+  CHECK(mySensor.measureRawSignals() == SGP30_SUCCESS);
+  CHECK(mySensor.H2 == sim.H2 && mySensor.ethanol == sim.ethanol);
+  CHECK(mySensor.measureTest() == SGP30_SUCCESS);
+  sim.selfTestResult = 0x1234;
+  CHECK(mySensor.measureTest() == SGP30_SELF_TEST_FAIL);
+  sim.selfTestResult = 0xD400;
+  //The self test ends air quality mode
+  mySensor.initAirQuality();
+  delay(15000);
+
+  //Split-phase state machine
+  CHECK(mySensor.readAirQuality() == SGP30_ERR_NOT_READY);
+  CHECK(mySensor.startAirQuality() == SGP30_SUCCESS);
+  CHECK(mySensor.isBusy() && !mySensor.isReady());
+  CHECK(mySensor.startRawSignals() == SGP30_ERR_BUSY);
+  CHECK(mySensor.readAirQuality() == SGP30_ERR_NOT_READY);
+  CHECK(mySensor.readRawSignals() == SGP30_ERR_NOT_READY);
+  delay(mySensor.msUntilReady());
+  CHECK(mySensor.isReady() && mySensor.msUntilReady() == 0);
+  //A finished result is not thrown away by another command
+  CHECK(mySensor.getBaseline() == SGP30_ERR_BUSY && mySensor.initAirQuality() == SGP30_ERR_BUSY);
+  CHECK(mySensor.isPending(measure_air_quality) && !mySensor.isPending(get_baseline));
+  CHECK(mySensor.readAirQuality() == SGP30_SUCCESS);
+  CHECK(!mySensor.isBusy() && !mySensor.isPending(measure_air_quality));
+  //unless its owner gives it up
+  CHECK(mySensor.startAirQuality() == SGP30_SUCCESS);
+  mySensor.cancel();
+  delay(20); //the sensor itself won't take a command before it is done
+  CHECK(mySensor.getBaseline() == SGP30_SUCCESS && mySensor.readAirQuality() == SGP30_ERR_NOT_READY);
+
+  //Readiness survives millis() rollover
+  hostSetMicros(0xFFFFFFF0ULL * 1000);
+  CHECK(mySensor.startAirQuality() == SGP30_SUCCESS);
+  delay(20);
+  CHECK(millis() < 20);
+  CHECK(mySensor.readAirQuality() == SGP30_SUCCESS);
+
+  //Injected faults must be reported and must not publish data
+  sim.CO2 = 999;
+  sim.nackReads = 1;
+  CHECK(mySensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  sim.shortReads = 1;
+  CHECK(mySensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  sim.badCRCs = 1;
+  CHECK(mySensor.measureAirQuality() == SGP30_ERR_BAD_CRC);
+  CHECK(mySensor.CO2 == 1234);
+  sim.badCRCs = 1;
+  CHECK(mySensor.getSerialID() == SGP30_ERR_BAD_CRC);
+  sim.nackWrites = 1;
+  CHECK(mySensor.measureRawSignals() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(mySensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(mySensor.CO2 == 999);
+
+  //General call reset drops the sensor out of air quality mode
+  mySensor.generalCallReset();
+  CHECK(!sim.initialized());
+}
+
+static void checkArray(void)
+{
+  Wire.detachAll();
+  TCA9548ASim mux0, mux1;
+  SGP30Sim sims[12];
+  for (uint8_t i = 0; i < 12; i++)
+  {
+    sims[i].serialID = 0x100 + i;
+    sims[i].CO2 = 500 + i;
+    (i < 8 ? mux0 : mux1).attach(i % 8, 0x58, &sims[i]);
+  }
+  Wire.attach(0x70, &mux0);
+  Wire.attach(0x71, &mux1);
+
+  SGP30Array<12> array;
+  CHECK(array.begin(Wire) == 12);
+  for (uint8_t i = 0; i < 12; i++)
+    CHECK(array.sensors[i].serialID == sims[i].serialID);
+  array.initAirQuality();
+  delay(15000);
+
+  uint64_t start = hostMicros();
+  CHECK(array.measureAirQuality() == 12);
+  uint64_t elapsed = hostMicros() - start;
+  printf("SGP30Array<12> measureAirQuality: %llu us simulated\n", (unsigned long long)elapsed);
+  CHECK(elapsed < 2 * 13000); //one wait, not one per sensor
+  for (uint8_t i = 0; i < 12; i++)
+    CHECK(array.status[i] == SGP30_SUCCESS && array.sensors[i].CO2 == sims[i].CO2);
+
+  //A single sensor array never rewrites the mux
+  SGP30Array<1> single;
+  unsigned long selects = mux0.selects;
+  single.begin(Wire);
+  single.measureAirQuality();
+  single.measureAirQuality();
+  CHECK(mux0.selects - selects == 1);
+
+  sims[3].badCRCs = 1;
+  sims[9].nackReads = 1;
+  CHECK(array.measureAirQuality() == 10);
+  CHECK(array.status[3] == SGP30_ERR_BAD_CRC);
+  CHECK(array.status[9] == SGP30_ERR_I2C_TIMEOUT);
+
+  //Calls on one sensor reach it, not the one the bulk loop selected last
+  for (uint8_t i = 0; i < 12; i++)
+    sims[i].baselineTVOC = 0x8000 + i;
+  CHECK(array.measureAirQuality() == 12);
+  CHECK(array.sensors[2].getBaseline() == SGP30_SUCCESS && array.sensors[2].baselineTVOC == 0x8002);
+  array.sensors[9].setHumidity(0x0B00);
+  CHECK(sims[9].humidity == 0x0B00 && sims[11].humidity != 0x0B00 && sims[2].humidity != 0x0B00);
+  delay(10);
+  CHECK(array.sensors[2].measureAirQuality() == SGP30_SUCCESS && array.sensors[2].CO2 == sims[2].CO2);
+  Wire.detachAll();
+}
+
+//History statistics against a brute force rescan of the same stream
+static void checkHistory(void)
+{
+  Wire.attach(0x58, &sim);
+  sim = SGP30Sim();
+  SGP30History<100> history;
+  mySensor.begin(Wire);
+  mySensor.attachHistory(history, SGP30_HISTORY_AIR_QUALITY | SGP30_HISTORY_RAW_SIGNALS);
+  mySensor.initAirQuality();
+  delay(16000);
+
+  static SGP30Sample all[400];
+  uint16_t lowest = 0xFFFF, highest = 0;
+  for (uint16_t i = 0; i < 400; i++)
+  {
+    sim.CO2 = 400 + (i * 37) % 500;
+    sim.TVOC = (i * 11) % 90;
+    delay(1000 - 12);
+    CHECK(mySensor.measureAirQuality() == SGP30_SUCCESS);
+    all[i] = history.get(0);
+    CHECK(all[i].CO2 == sim.CO2 && all[i].TVOC == sim.TVOC);
+    if (sim.CO2 < lowest)
+      lowest = sim.CO2;
+    if (sim.CO2 > highest)
+      highest = sim.CO2;
+  }
+  CHECK(history.size() == 100);
+  CHECK(history.minimum(SGP30_SIGNAL_CO2) == lowest && history.maximum(SGP30_SIGNAL_CO2) == highest);
+  CHECK(history.get(99).CO2 == all[300].CO2);
+
+  uint32_t sum = 0, windowSum = 0, windowCount = 0;
+  for (uint16_t i = 300; i < 400; i++)
+  {
+    sum += all[i].CO2;
+    if (all[399].timestamp - all[i].timestamp < 60000UL)
+    {
+      windowSum += all[i].CO2;
+      windowCount++;
+    }
+  }
+  CHECK(history.mean(SGP30_SIGNAL_CO2) == (sum + 50) / 100);
+  CHECK(history.windowCount(SGP30_WINDOW_1MIN) == windowCount);
+  CHECK(history.windowMean(SGP30_SIGNAL_CO2, SGP30_WINDOW_1MIN) == (windowSum + windowCount / 2) / windowCount);
+  //15 minutes is longer than the buffer, the window holds everything still buffered
+  CHECK(history.windowCount(SGP30_WINDOW_15MIN) == 100);
+
+  //Raw signals add samples too, with the last air quality values
+  sim.H2 = 12345;
+  CHECK(mySensor.measureRawSignals() == SGP30_SUCCESS);
+  CHECK(history.get(0).H2 == 12345 && history.get(0).CO2 == all[399].CO2);
+  CHECK(history.sources(0) == SGP30_HISTORY_RAW_SIGNALS && history.sources(1) == SGP30_HISTORY_AIR_QUALITY);
+  //and only the signals they carry count in the statistics
+  CHECK(history.minimum(SGP30_SIGNAL_H2) == 12345 && history.maximum(SGP30_SIGNAL_H2) == 12345);
+  CHECK(history.mean(SGP30_SIGNAL_H2) == 12345 && history.ema(SGP30_SIGNAL_H2) == 12345);
+  CHECK(history.windowMean(SGP30_SIGNAL_H2, SGP30_WINDOW_1MIN) == 12345);
+  CHECK(history.minimum(SGP30_SIGNAL_CO2) == lowest && history.maximum(SGP30_SIGNAL_CO2) == highest);
+  //the raw sample pushed out all[300], 99 air quality samples are left
+  CHECK(history.mean(SGP30_SIGNAL_CO2) == (sum - all[300].CO2 + 49) / 99);
+
+  //Interleaved sources keep separate averages
+  history.clear();
+  for (uint8_t i = 0; i < 20; i++)
+  {
+    history.push({(unsigned long)i * 1000, 500, 50, 0, 0}, SGP30_HISTORY_AIR_QUALITY);
+    history.push({(unsigned long)i * 1000 + 500, 0, 0, 13000, 19000}, SGP30_HISTORY_RAW_SIGNALS);
+  }
+  CHECK(history.size() == 40 && history.windowCount(SGP30_WINDOW_1MIN) == 40);
+  CHECK(history.mean(SGP30_SIGNAL_CO2) == 500 && history.minimum(SGP30_SIGNAL_CO2) == 500);
+  CHECK(history.mean(SGP30_SIGNAL_ETHANOL) == 19000 && history.minimum(SGP30_SIGNAL_H2) == 13000);
+  CHECK(history.ema(SGP30_SIGNAL_TVOC) == 50 && history.windowMean(SGP30_SIGNAL_H2, SGP30_WINDOW_1MIN) == 13000);
+
+  //A constant signal converges the EMA to that value
+  history.clear();
+  for (uint8_t i = 0; i < 100; i++)
+    history.push({(unsigned long)i * 1000, 800, 0, 0, 0});
+  CHECK(history.ema(SGP30_SIGNAL_CO2) == 800 && history.mean(SGP30_SIGNAL_CO2) == 800);
+  //Out of range arguments are harmless: no such window, the slowest average
+  CHECK(history.windowCount(SGP30_WINDOWS) == 0 && history.windowMean(SGP30_SIGNAL_CO2, SGP30_WINDOWS) == 0);
+  history.setEMAShift(40);
+  history.push({100000, 1000, 0, 0, 0});
+  CHECK(history.ema(SGP30_SIGNAL_CO2) == 800);
+  history.setEMAShift(3);
+  mySensor.detachHistory(history);
+  Wire.detachAll();
+}
+
+static unsigned long wallClock = 1700000000UL;
+static unsigned long wallSeconds(void) { return wallClock + millis() / 1000; }
+
+//Baseline persistence across simulated reboots, for EEPROM and flash semantics
+static void checkBaseline(bool flash)
+{
+  //A fresh name in the temporary directory, whatever the working directory
+  char path[] = P_tmpdir "/sgp30_baselineXXXXXX";
+  int file = mkstemp(path);
+  CHECK(file >= 0);
+  close(file);
+  remove(path); //SGP30FileStorage creates it blank
+  Wire.attach(0x58, &sim);
+  sim = SGP30Sim();
+  hostSetMicros(0);
+
+  //Cold start: nothing stored, first save after 12 hours
+  {
+    SGP30FileStorage storage(path, 200, flash ? 100 : 0);
+    SGP30BaselineManager manager(storage);
+    manager.setClock(wallSeconds);
+    SGP30 sensor;
+    sensor.attachBaselineManager(manager);
+    CHECK(sensor.begin(Wire));
+    sensor.initAirQuality();
+    CHECK(!manager.restored());
+    for (unsigned long s = 0; s < 12UL * 3600 + 5; s++)
+    {
+      delay(1000 - 12);
+      sensor.measureAirQuality();
+    }
+    CHECK(manager.writes == 1);
+    //Unchanged baseline is not rewritten, a changed one is
+    for (unsigned long s = 0; s < 3600; s++)
+    {
+      delay(1000 - 12);
+      sensor.measureAirQuality();
+    }
+    CHECK(manager.writes == 1);
+    sim.baselineCO2 = 0x9001;
+    for (unsigned long s = 0; s < 3600; s++)
+    {
+      delay(1000 - 12);
+      sensor.measureAirQuality();
+    }
+    CHECK(manager.writes == 2);
+  }
+
+  //Reboot: the newest record is restored straight after init
+  {
+    sim.reset();
+    sim.baselineCO2 = 0;
+    sim.baselineTVOC = 0;
+    SGP30FileStorage storage(path, 200, flash ? 100 : 0);
+    SGP30BaselineManager manager(storage);
+    manager.setClock(wallSeconds);
+    SGP30 sensor;
+    sensor.attachBaselineManager(manager);
+    sensor.begin(Wire);
+    sensor.initAirQuality();
+    CHECK(manager.restored());
+    CHECK(sim.baselineCO2 == 0x9001 && sim.baselineTVOC == 0x8E12);
+
+    //Initialising again (a self test, reinitialize()) keeps the live
+    //baseline instead of the stored one, and the save schedule
+    sim.baselineTVOC = 0x8F00;
+    sensor.initAirQuality();
+    delay(10);
+    CHECK(manager.restored() && sim.baselineTVOC == 0x8F00);
+    sim.baselineTVOC = 0x8E12;
+
+    //Many changes rotate through every slot, wear is spread evenly
+    for (uint16_t i = 0; i < 95; i++)
+    {
+      sim.baselineTVOC = 0x7000 + i;
+      CHECK(manager.save(sensor));
+    }
+    unsigned long most = 0, least = 0xFFFFFFFF;
+    for (uint16_t b = 0; b < 200; b++)
+    {
+      if (storage.byteWrites[b] > most)
+        most = storage.byteWrites[b];
+      if (storage.byteWrites[b] < least)
+        least = storage.byteWrites[b];
+    }
+    CHECK(most - least <= 1);
+    //97 records in two pages of 5: every page start after the first two erases
+    CHECK(!flash || storage.erases == 18);
+  }
+
+  //Newest record wins after wrapping, and another sensor's record is ignored
+  {
+    SGP30FileStorage storage(path, 200, flash ? 100 : 0);
+    SGP30BaselineManager manager(storage);
+    manager.setClock(wallSeconds);
+    SGP30 sensor;
+    sensor.attachBaselineManager(manager);
+    sim.serialID = 0x0000BADC0FFEULL;
+    sensor.begin(Wire);
+    sensor.initAirQuality();
+    CHECK(!manager.restored());
+    delay(10);
+    sim.serialID = SGP30Sim().serialID;
+    sensor.begin(Wire);
+    sensor.initAirQuality();
+    CHECK(manager.restored());
+    CHECK(sim.baselineTVOC == 0x7000 + 94);
+  }
+
+  //Powered off for more than a week: stale, not restored
+  {
+    wallClock += 8UL * 24 * 3600;
+    SGP30FileStorage storage(path, 200, flash ? 100 : 0);
+    SGP30BaselineManager manager(storage);
+    manager.setClock(wallSeconds);
+    SGP30 sensor;
+    sensor.attachBaselineManager(manager);
+    sensor.begin(Wire);
+    sim.baselineTVOC = 0;
+    sensor.initAirQuality();
+    CHECK(!manager.restored() && sim.baselineTVOC == 0);
+  }
+
+  //Two sensors sharing a region: neither overwrites the other's record
+  remove(path);
+  {
+    SGP30FileStorage storage(path, 200, flash ? 100 : 0);
+    SGP30BaselineManager first(storage), second(storage);
+    SGP30 one, two;
+    one.attachBaselineManager(first);
+    two.attachBaselineManager(second);
+    one.begin(Wire);
+    two.begin(Wire);
+    two.serialID ^= 1; //one simulated device, two identities
+    one.initAirQuality();
+    two.initAirQuality();
+    delay(10);
+    sim.baselineTVOC = 0x7101;
+    CHECK(first.save(one));
+    sim.baselineTVOC = 0x7202;
+    CHECK(second.save(two));
+    sim.baselineTVOC = 0x7303;
+    CHECK(first.save(one));
+
+    SGP30BaselineManager reboot(storage);
+    sim.baselineTVOC = 0;
+    reboot.onInit(one);
+    CHECK(reboot.restored() && sim.baselineTVOC == 0x7303);
+    sim.baselineTVOC = 0;
+    reboot.onInit(two);
+    CHECK(reboot.restored() && sim.baselineTVOC == 0x7202);
+  }
+
+  //Power lost after an erase: the newest record is still in the other page
+  remove(path);
+  {
+    SGP30FileStorage storage(path, 200, flash ? 100 : 0);
+    SGP30BaselineManager manager(storage);
+    SGP30 sensor;
+    sensor.begin(Wire);
+    for (uint16_t i = 0; i < 10; i++)
+    {
+      sim.baselineTVOC = 0x7400 + i;
+      CHECK(manager.save(sensor));
+    }
+    storage.failWrites = true;
+    sim.baselineTVOC = 0x7500;
+    CHECK(!manager.save(sensor));
+    CHECK(!flash || storage.erases == 1);
+
+    SGP30BaselineManager reboot(storage);
+    sim.baselineTVOC = 0;
+    reboot.onInit(sensor);
+    CHECK(reboot.restored() && sim.baselineTVOC == 0x7400 + 9);
+  }
+
+  //Power lost during a write: the torn slot is not written over, the
+  //newest record before it survives
+  remove(path);
+  {
+    SGP30FileStorage storage(path, 200, flash ? 100 : 0);
+    SGP30BaselineManager manager(storage);
+    SGP30 sensor;
+    sensor.begin(Wire);
+    sim.baselineTVOC = 0x7600;
+    CHECK(manager.save(sensor));
+    const uint8_t torn[3] = {0x00, 0x00, 0x00};
+    CHECK(storage.write(SGP30_BASELINE_RECORD_SIZE, torn, sizeof(torn)));
+    sim.baselineTVOC = 0x7601;
+    CHECK(manager.save(sensor));
+    CHECK(storage.erases == 0);
+
+    SGP30BaselineManager reboot(storage);
+    sim.baselineTVOC = 0;
+    reboot.onInit(sensor);
+    CHECK(reboot.restored() && sim.baselineTVOC == 0x7601);
+  }
+  remove(path);
+  Wire.detachAll();
+}
+
+//The driver against the memory transport, frame by frame
+static void checkTransport(void)
+{
+  SGP30MemoryTransport memory;
+  SGP30 sensor;
+  const uint16_t serial[3] = {0x0000, 0x0123, 0x4567};
+  const uint16_t featureSet[1] = {0x0022};
+  CHECK(memory.respondWords(serial, 3));
+  CHECK(memory.respondWords(featureSet, 1));
+  CHECK(sensor.begin(memory));
+  CHECK(sensor.serialID == 0x01234567);
+  CHECK(sensor.supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE | SGP30_CAP_SET_TVOC_BASELINE));
+  CHECK(memory.writes == 2 && memory.reads == 2);
+  CHECK(memory.lastAddress == 0x58 && memory.lastWriteLength == 2);
+  CHECK(memory.lastWrite[0] == 0x20 && memory.lastWrite[1] == 0x2F);
+
+  const uint16_t airQuality[2] = {450, 12};
+  memory.clear();
+  CHECK(memory.respondWords(airQuality, 2));
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.CO2 == 450 && sensor.TVOC == 12);
+  CHECK(memory.writes == 1 && memory.reads == 1 && memory.pending() == 0);
+  CHECK(memory.lastWrite[0] == 0x20 && memory.lastWrite[1] == 0x08);
+
+  //set_baseline goes out as one frame, TVOC first
+  sensor.setBaseline(0x8A3C, 0x8E12);
+  CHECK(memory.lastWriteLength == 8);
+  CHECK(memory.lastWrite[2] == 0x8E && memory.lastWrite[3] == 0x12 && memory.lastWrite[4] == sgp30CRC8Word(0x8E12));
+  CHECK(memory.lastWrite[5] == 0x8A && memory.lastWrite[6] == 0x3C && memory.lastWrite[7] == sgp30CRC8Word(0x8A3C));
+
+  //Corrupt checksum, short response and NACK
+  const uint8_t corrupt[6] = {0x01, 0xC2, 0x00, 0x00, 0x0C, sgp30CRC8Word(12)};
+  CHECK(memory.respond(corrupt, 6));
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_BAD_CRC);
+  CHECK(sensor.CO2 == 450);
+  CHECK(memory.respondWords(airQuality, 1));
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(memory.pending() == 3); //nothing consumed
+  memory.clear();
+  memory.nack = true;
+  CHECK(memory.respondWords(airQuality, 2));
+  unsigned long before = millis();
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(millis() == before); //no wait for a command the sensor never took
+  CHECK(sensor.startAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(!sensor.isBusy());
+  CHECK(sensor.initAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  memory.nack = false;
+
+  sensor.generalCallReset();
+  CHECK(memory.lastAddress == 0x00 && memory.lastWriteLength == 1 && memory.lastWrite[0] == 0x06);
+
+  //The Linux backend fails cleanly without a device
+  SGP30LinuxI2C bus;
+  CHECK(!bus.begin("/dev/i2c-does-not-exist"));
+  CHECK(!sensor.begin(bus));
+  CHECK(bus.syscalls == 0);
+}
+
+//An hour of 1 Hz measurements from a loop() with uneven work, across a
+//millis() rollover, against the "1 second after the last one" idiom
+static void checkScheduler(void)
+{
+  sim = SGP30Sim();
+  hostSetMicros(((uint64_t)0xFFFFFFFF - 1800000) * 1000); //half an hour before millis() rolls over
+  Wire.attach(0x58, &sim);
+  CHECK(mySensor.begin(Wire));
+  mySensor.initAirQuality();
+  delay(10);
+
+  unsigned long t1 = millis();
+  unsigned long first = t1;
+  for (unsigned long n = 0; n < 3600;)
+  {
+    if ((uint32_t)(millis() - t1) >= 1000)
+    {
+      t1 = millis();
+      mySensor.measureAirQuality();
+      n++;
+    }
+    delay(7); //other work
+  }
+  uint32_t naiveDrift = t1 - first - 3599 * 1000;
+
+  SGP30Scheduler scheduler;
+  scheduler.begin(mySensor);
+  first = scheduler.deadline();
+  unsigned long readings = 0, iterations = 0;
+  while (scheduler.ticks < 3600 || mySensor.isBusy())
+  {
+    SGP30ERR error = scheduler.update();
+    if (error == SGP30_SUCCESS)
+      readings++;
+    else
+      CHECK(error == SGP30_ERR_NOT_READY);
+    delay(scheduler.msUntilNext());
+    if (++iterations % 7 == 0)
+      delay(5); //other work, sometimes running past a deadline
+  }
+  printf("1 h at 1 Hz: drift %lu ms with millis() - t1 >= 1000, %lu ms scheduled "
+         "(jitter max %lu us, mean %lu us, lateness max %lu ms)\n",
+         (unsigned long)naiveDrift, (unsigned long)(uint32_t)(scheduler.deadline() - first - 3600 * 1000),
+         scheduler.maxJitter, scheduler.meanJitter(), scheduler.maxLateness);
+  CHECK(readings == 3600);
+  CHECK((uint32_t)(scheduler.deadline() - first) == 3600UL * 1000);
+  CHECK(scheduler.missed == 0);
+  CHECK(scheduler.maxLateness <= 5);
+  CHECK(scheduler.minInterval >= 994000 && scheduler.maxInterval <= 1006000); //lateness plus bus time
+  CHECK(millis() < 2 * 3600000UL); //rolled over on the way
+
+  //A stall longer than a period skips deadlines instead of bunching them up
+  delay(3500);
+  CHECK(scheduler.msUntilNext() == 0);
+  CHECK(scheduler.update() == SGP30_ERR_NOT_READY);
+  CHECK(scheduler.missed == 3);
+  CHECK(mySensor.isBusy());
+  CHECK((uint32_t)(scheduler.deadline() - first) % 1000 == 0); //same phase
+  delay(scheduler.msUntilNext());
+  CHECK(scheduler.update() == SGP30_SUCCESS);
+
+  //A measurement dropped before it was read is lost, not waited for forever
+  delay(scheduler.msUntilNext());
+  CHECK(scheduler.update() == SGP30_ERR_NOT_READY);
+  CHECK(mySensor.getBaseline() == SGP30_ERR_BUSY);
+  mySensor.cancel();
+  delay(20);
+  unsigned long ticks = scheduler.ticks;
+  CHECK(scheduler.update() == SGP30_ERR_NOT_READY);
+  CHECK(scheduler.lost == 1);
+  readings = 0;
+  while (scheduler.ticks < ticks + 5)
+  {
+    delay(scheduler.msUntilNext());
+    if (scheduler.update() == SGP30_SUCCESS)
+      readings++;
+  }
+  delay(scheduler.msUntilNext());
+  if (scheduler.update() == SGP30_SUCCESS)
+    readings++;
+  CHECK(readings == 5);
+  CHECK(scheduler.lost == 1);
+  Wire.detachAll();
+}
+
+//Retries, escalation to a re-init that keeps baseline and humidity, and
+//the warm-up that follows it
+static void checkRecovery(void)
+{
+  sim = SGP30Sim();
+  hostSetMicros(0);
+  Wire.attach(0x58, &sim);
+  SGP30 sensor;
+  SGP30Recovery recovery;
+  CHECK(sensor.begin(Wire));
+  sensor.attachRecovery(recovery);
+  sensor.initAirQuality();
+  delay(10);
+  CHECK(recovery.state() == SGP30_STATE_WARMUP);
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.CO2 == 400 && recovery.state() == SGP30_STATE_WARMUP);
+  delay(15000);
+  sim.CO2 = 800;
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.CO2 == 800 && recovery.state() == SGP30_STATE_OK);
+
+  //A glitch is absorbed by a retry
+  sim.badCRCs = 1;
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(recovery.retried == 1 && recovery.recoveries == 0);
+  CHECK(recovery.state() == SGP30_STATE_OK);
+
+  sim.baselineCO2 = 0x8A3C;
+  sim.baselineTVOC = 0x8E12;
+  CHECK(sensor.getBaseline() == SGP30_SUCCESS);
+  sensor.setHumidity(0x0A00);
+  delay(10);
+
+  //Three failed attempts in a row re-initialize the sensor, the sensor loses
+  //its calibration and compensation in the reset and gets them back
+  sim.nackReads = 3;
+  sim.baselineCO2 = 0;
+  sim.baselineTVOC = 0;
+  sim.humidity = 0;
+  unsigned long start = millis();
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(millis() - start < 200); //bounded
+  CHECK(recovery.recoveries == 1 && recovery.failures() == 0);
+  CHECK(recovery.state() == SGP30_STATE_WARMUP); //holding the last real values
+  CHECK(sim.initialized());
+  CHECK(sim.baselineCO2 == 0x8A3C && sim.baselineTVOC == 0x8E12);
+  CHECK(sim.humidity == 0x0A00);
+
+  //Warm-up values from the re-initialized sensor are not published
+  sim.CO2 = 900;
+  unsigned long retried = recovery.retried;
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_NOT_READY); //read, nothing new
+  CHECK(sensor.CO2 == 800 && recovery.retried == retried);
+  CHECK(recovery.state() == SGP30_STATE_WARMUP);
+  delay(15000);
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.CO2 == 900 && recovery.state() == SGP30_STATE_OK);
+
+  //A sensor that is gone stays degraded, every call returns in bounded time
+  Wire.detachAll();
+  CHECK(sensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(recovery.resets == 2 && recovery.recoveries == 1);
+  CHECK(recovery.failures() == 0 && recovery.state() == SGP30_STATE_DEGRADED); //the reset failed
+  for (int i = 1; i < 5; i++)
+  {
+    start = millis();
+    CHECK(sensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+    CHECK(millis() - start < 200);
+  }
+  CHECK(recovery.recoveries == 1);
+  CHECK(recovery.state() == SGP30_STATE_DEGRADED);
+  CHECK(sensor.CO2 == 900);
+
+  //Each fruitless reset doubles the failures before the next one: resets
+  //after 3, 6, 12 and 24 failures (3 attempts per reading), then it gives up
+  for (int i = 5; i < 15; i++)
+    CHECK(sensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(recovery.resets == 1 + 4 && recovery.state() == SGP30_STATE_FAILED);
+  for (int i = 0; i < 100; i++)
+    sensor.measureAirQuality();
+  CHECK(recovery.resets == 1 + 4 && recovery.recoveries == 1);
+  CHECK(recovery.state() == SGP30_STATE_FAILED && sensor.CO2 == 900);
+
+  //A good reading is a fresh start
+  Wire.attach(0x58, &sim);
+  sim.CO2 = 950;
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  CHECK(sensor.CO2 == 950 && recovery.state() == SGP30_STATE_OK);
+
+  //A reset is only a recovery if the sensor acknowledges the init after it
+  sim.nackInits = 1;
+  CHECK(!sensor.reinitialize());
+  CHECK(!sim.initialized());
+  CHECK(sensor.reinitialize());
+  CHECK(sim.initialized());
+}
+
+//Capabilities from the feature set, fast startup on newer chips, clean
+//fallback on older ones
+static void checkCapabilities(void)
+{
+  sim = SGP30Sim();
+  Wire.attach(0x58, &sim);
+  SGP30 sensor;
+
+  //Feature set 0x20: no inceptive baseline, init sends init alone
+  CHECK(sensor.begin(Wire));
+  CHECK(sensor.featureSetVersion == 0x0020);
+  CHECK(!sensor.supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE));
+  CHECK(!sensor.supports(SGP30_CAP_SET_TVOC_BASELINE));
+  CHECK(sensor.getTVOCInceptiveBaseline() == SGP30_ERR_UNSUPPORTED);
+  CHECK(sensor.setTVOCBaseline(0x1234) == SGP30_ERR_UNSUPPORTED);
+  CHECK(!sensor.isBusy());
+  unsigned long commands = sim.commands;
+  sensor.initAirQuality();
+  delay(10);
+  CHECK(sim.commands - commands == 1);
+  CHECK(sim.rejected == 0);
+
+  //Feature set 0x22: once asked for, init starts TVOC from the inceptive baseline
+  sim = SGP30Sim();
+  sim.featureSetVersion = 0x0022;
+  CHECK(sensor.begin(Wire));
+  CHECK(sensor.supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE | SGP30_CAP_SET_TVOC_BASELINE));
+  sensor.setFastStartup(true);
+  CHECK(sensor.initAirQuality() == SGP30_SUCCESS);
+  delay(10);
+  CHECK(sensor.inceptiveBaselineTVOC == sim.inceptiveBaselineTVOC);
+  CHECK(sim.baselineTVOC == sim.inceptiveBaselineTVOC);
+  CHECK(sim.rejected == 0);
+  CHECK(sensor.measureAirQuality() == SGP30_SUCCESS);
+  //A failed inceptive baseline read is reported, air quality mode runs anyway
+  sim.nackReads = 1;
+  CHECK(sensor.initAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  CHECK(sim.initialized());
+  delay(10);
+
+  //Not when there is a baseline to restore, or by default
+  SGP30 known;
+  sim = SGP30Sim();
+  sim.featureSetVersion = 0x0022;
+  CHECK(known.begin(Wire));
+  known.setFastStartup(true);
+  known.setBaseline(0x8A3C, 0x1234);
+  delay(10);
+  known.initAirQuality();
+  delay(10);
+  CHECK(sim.baselineTVOC == 0x1234);
+  SGP30 off;
+  sim = SGP30Sim();
+  sim.featureSetVersion = 0x0022;
+  CHECK(off.begin(Wire));
+  commands = sim.commands;
+  off.initAirQuality();
+  delay(10);
+  CHECK(sim.commands - commands == 1);
+
+  //Another product type shares nothing
+  sim.featureSetVersion = 0x1022;
+  CHECK(off.begin(Wire));
+  CHECK(!off.supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE));
+  Wire.detachAll();
+}
+
+//Self test in the background while the scheduler keeps measuring, then
+//the health signals between tests
+static void checkHealth(void)
+{
+  sim = SGP30Sim();
+  Wire.attach(0x58, &sim);
+  SGP30 sensor;
+  CHECK(sensor.begin(Wire));
+  sensor.initAirQuality();
+  delay(10);
+  sim.baselineCO2 = 0x8A3C;
+  sim.baselineTVOC = 0x8C12;
+  sim.CO2 = 500;
+  SGP30Scheduler scheduler;
+  scheduler.begin(sensor);
+  SGP30HealthMonitor monitor;
+  monitor.begin(sensor);
+
+  unsigned long readings = 0, errors = 0;
+  uint64_t longest = 0;
+  SGP30ERR result = SGP30_ERR_NOT_READY;
+  while (readings < 60)
+  {
+    if (readings == 20 && !monitor.testing() && monitor.tests == 0)
+      monitor.startTest();
+    uint64_t start = hostMicros();
+    SGP30ERR error = scheduler.update();
+    monitor.recordAirQuality(error);
+    if (error == SGP30_SUCCESS)
+      readings++;
+    else if (error != SGP30_ERR_NOT_READY && error != SGP30_ERR_BUSY)
+      errors++;
+    SGP30ERR test = monitor.update();
+    if (test != SGP30_ERR_NOT_READY)
+      result = test;
+    if (!sim.initialized() && sim.baselineCO2 == 0x8A3C)
+      sim.baselineCO2 = 0; //lost to the test, like on the chip
+    if (hostMicros() - start > longest)
+      longest = hostMicros() - start;
+    delay(monitor.testing() ? 1 : scheduler.msUntilNext());
+  }
+  printf("self test while measuring: longest update %lu us, %lu ticks for 60 readings\n",
+         (unsigned long)longest, scheduler.ticks);
+  CHECK(result == SGP30_SUCCESS && monitor.lastTest == SGP30_SUCCESS);
+  CHECK(monitor.tests == 1 && monitor.testFailures == 0);
+  CHECK(errors == 0);
+  CHECK(longest < 25000); //the two 10ms waits after the test, never the test itself
+  CHECK(sim.initialized());
+  CHECK(sim.baselineCO2 == 0x8A3C && sim.baselineTVOC == 0x8C12);
+  CHECK(sensor.CO2 == 500); //back to real readings 15 s after the re-init
+  CHECK(monitor.score() == 100);
+
+  //A failed test takes the score to 0, and air quality mode still comes back
+  sim.selfTestResult = 0x1234;
+  monitor.startTest();
+  while (monitor.update() == SGP30_ERR_NOT_READY)
+    delay(1);
+  CHECK(monitor.lastTest == SGP30_SELF_TEST_FAIL && monitor.testFailures == 1);
+  CHECK(monitor.score() == 0);
+  CHECK(sim.initialized());
+  sim.selfTestResult = 0xD400;
+
+  //A step dropped by cancel() is run again instead of waited for forever
+  monitor.startTest();
+  CHECK(monitor.update() == SGP30_ERR_NOT_READY && sensor.isPending(get_baseline));
+  sensor.cancel();
+  delay(20);
+  CHECK(monitor.update() == SGP30_ERR_NOT_READY && monitor.testing());
+  delay(20);
+  CHECK(monitor.update() == SGP30_ERR_NOT_READY && sensor.isPending(get_baseline));
+  delay(20);
+  CHECK(monitor.update() == SGP30_ERR_NOT_READY && sensor.isPending(measure_test));
+  sensor.cancel();
+  delay(250);
+  CHECK(monitor.update() == SGP30_ERR_NOT_READY && monitor.testing());
+  CHECK(monitor.update() == SGP30_ERR_NOT_READY && sensor.isPending(measure_test));
+  while (monitor.update() == SGP30_ERR_NOT_READY)
+    delay(1);
+  CHECK(monitor.lastTest == SGP30_SUCCESS && !monitor.testing());
+  CHECK(monitor.tests == 3 && monitor.testFailures == 1);
+  CHECK(sim.initialized());
+
+  //Bus errors
+  monitor.begin(sensor);
+  delay(15000);
+  for (int i = 0; i < 100; i++)
+  {
+    if (i % 10 == 0)
+      sim.badCRCs = 1;
+    sim.CO2 = 500 + i;
+    monitor.recordAirQuality(sensor.measureAirQuality());
+  }
+  CHECK(monitor.readings == 100 && monitor.crcErrors == 10);
+  CHECK(monitor.errorRate() == 100);
+  CHECK(monitor.score() == 75);
+
+  //Raw signals: the first readings are the reference, drift and stuck from there
+  monitor.begin(sensor);
+  for (int i = 0; i < 200; i++)
+  {
+    sim.H2 = 13600 + (i & 3);
+    sim.ethanol = 18200 - (i & 1);
+    monitor.recordRawSignals(sensor.measureRawSignals());
+  }
+  CHECK(monitor.referenceH2 == 13602 && monitor.referenceEthanol == 18200);
+  CHECK(monitor.drift() <= 1 && !monitor.stuck());
+  for (int i = 0; i < 400; i++)
+  {
+    sim.H2 = 13600 - 512 + (i & 3);
+    monitor.recordRawSignals(sensor.measureRawSignals());
+  }
+  CHECK(monitor.drift() >= 500 && monitor.drift() <= 514);
+  CHECK(monitor.score() == 86);
+  for (int i = 0; i < SGP30_STUCK_RAW_SIGNALS; i++)
+    monitor.recordRawSignals(sensor.measureRawSignals());
+  CHECK(monitor.stuck());
+  CHECK(monitor.score() == 46);
+  Wire.detachAll();
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000;
+  Wire.setClock(400000);
+  Wire.attach(0x58, &sim);
+  mySensor.begin(Wire);
+  benchmarks(iterations);
+  checkResults();
+  checkTransport();
+  checkArray();
+  checkHistory();
+  checkBaseline(false);
+  checkBaseline(true);
+  checkScheduler();
+  checkRecovery();
+  checkCapabilities();
+  checkHealth();
+  return checkSummary();
+}
@@ -0,0 +1,225 @@
+/*
+  Host stress test for the seqlock snapshot (SparkFun_SGP30_Snapshot.h).
+
+  A writer thread publishes while reader threads take snapshots with
+  tryReadSnapshot() and readSnapshot(), first straight through an
+  SGP30SnapshotCell as fast as possible, then through the driver measuring
+  the simulated sensor. Published values are tied together (TVOC = ~CO2,
+  ethanol = ~H2...) so a torn copy is detected, and sequence numbers and
+  timestamps must never go backwards for a reader. Reports the cost of a
+  copy and of a publish, and how many tries succeeded under contention
+  (with a single CPU, readers mostly run while the writer is preempted
+  mid-publish, so most tries fail). Exits non-zero if any copy was torn.
+*/
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Arduino.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+static std::atomic<bool> running;
+
+struct ReaderStats
+{
+  unsigned long attempts; //tryRead calls
+  unsigned long copies;   //consistent copies
+  unsigned long torn;     //copies that broke an invariant
+  unsigned long backwards; //sequence or timestamp went back
+};
+
+//Every field derived from one counter
+static SGP30Snapshot make(uint32_t i)
+{
+  SGP30Snapshot s;
+  s.sequence = 0;
+  s.timestamp = i;
+  s.CO2 = (uint16_t)i;
+  s.TVOC = (uint16_t)~i;
+  s.baselineCO2 = (uint16_t)(i * 3);
+  s.baselineTVOC = (uint16_t)(i >> 16);
+  s.H2 = (uint16_t)(i * 7);
+  s.ethanol = (uint16_t)(i ^ 0x5A5A);
+  return s;
+}
+
+static bool intact(const SGP30Snapshot &s)
+{
+  uint32_t i = (uint32_t)s.timestamp;
+  SGP30Snapshot expected = make(i);
+  return s.sequence == i && s.CO2 == expected.CO2 && s.TVOC == expected.TVOC && s.baselineCO2 == expected.baselineCO2 &&
+         s.baselineTVOC == expected.baselineTVOC && s.H2 == expected.H2 && s.ethanol == expected.ethanol;
+}
+
+//Values published by the driver, each pair from one measurement
+static bool intactDriver(const SGP30Snapshot &s)
+{
+  return s.TVOC == (uint16_t)~s.CO2 && s.ethanol == (uint16_t)~s.H2;
+}
+
+template <typename Read, typename Check>
+static void reader(Read read, Check check, ReaderStats *stats)
+{
+  ReaderStats r = {0, 0, 0, 0};
+  SGP30Snapshot snapshot, last = {0, 0, 0, 0, 0, 0, 0, 0};
+  while (running.load(std::memory_order_relaxed))
+  {
+    r.attempts++;
+    if (!read(snapshot))
+      continue;
+    r.copies++;
+    if (snapshot.sequence == 0)
+      continue; //nothing published yet
+    if (!check(snapshot))
+      r.torn++;
+    if (snapshot.sequence < last.sequence || (uint32_t)snapshot.timestamp < (uint32_t)last.timestamp)
+      r.backwards++;
+    last = snapshot;
+  }
+  *stats = r;
+}
+
+static int report(const char *name, std::vector<ReaderStats> &stats, unsigned long published)
+{
+  unsigned long attempts = 0, copies = 0, torn = 0, backwards = 0;
+  for (size_t i = 0; i < stats.size(); i++)
+  {
+    attempts += stats[i].attempts;
+    copies += stats[i].copies;
+    torn += stats[i].torn;
+    backwards += stats[i].backwards;
+  }
+  printf("%s: %lu published, %zu readers, %lu copies of %lu tries (%.2f%%), %lu torn, %lu backwards\n",
+         name, published, stats.size(), copies, attempts, attempts ? 100.0 * copies / attempts : 0.0, torn, backwards);
+  if (torn || backwards || copies == 0)
+  {
+    printf("FAIL: %s\n", name);
+    return 1;
+  }
+  return 0;
+}
+
+int main(void)
+{
+  int failures = 0;
+  const int readers = 3;
+
+  //Cost of an uncontended copy and of a publish
+  {
+    SGP30SnapshotCell cell;
+    SGP30Snapshot snapshot;
+    const int iterations = 10000000;
+    unsigned long copies = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+      copies += cell.tryRead(snapshot);
+    double readNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+      cell.publish(make(i));
+    double publishNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    printf("tryRead: %.1f ns, publish: %.1f ns (%u hardware threads)\n", readNs, publishNs, std::thread::hardware_concurrency());
+    if (copies != (unsigned long)iterations)
+      failures++;
+  }
+
+  //Cell alone, publishing back to back: the worst case for readers
+  {
+    SGP30SnapshotCell cell;
+    std::vector<ReaderStats> stats(readers + 1);
+    std::vector<std::thread> threads;
+    running = true;
+    for (int i = 0; i < readers; i++)
+      threads.push_back(std::thread([&cell, &stats, i]() {
+        reader([&cell](SGP30Snapshot &s) { return cell.tryRead(s); }, intact, &stats[i]);
+      }));
+    threads.push_back(std::thread([&cell, &stats]() {
+      reader([&cell](SGP30Snapshot &s) { cell.read(s); return true; }, intact, &stats[readers]);
+    }));
+    const uint32_t publishes = 2000000;
+    for (uint32_t i = 1; i <= publishes; i++)
+      cell.publish(make(i));
+    running = false;
+    for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+    failures += report("cell", stats, publishes);
+  }
+
+  //Through the driver, measuring the simulated sensor
+  {
+    SGP30Sim sim;
+    Wire.attach(0x58, &sim);
+    SGP30 mySensor;
+    if (!mySensor.begin(Wire))
+    {
+      printf("FAIL: begin\n");
+      return 1;
+    }
+    mySensor.initAirQuality();
+    delay(15000); //past the fixed 400 / 0 of the warm-up, which don't pair up
+    std::vector<ReaderStats> stats(readers + 1);
+    std::vector<std::thread> threads;
+    running = true;
+    for (int i = 0; i < readers; i++)
+      threads.push_back(std::thread([&mySensor, &stats, i]() {
+        reader([&mySensor](SGP30Snapshot &s) { return mySensor.tryReadSnapshot(s); }, intactDriver, &stats[i]);
+      }));
+    threads.push_back(std::thread([&mySensor, &stats]() {
+      reader([&mySensor](SGP30Snapshot &s) { mySensor.readSnapshot(s); return true; }, intactDriver, &stats[readers]);
+    }));
+    const uint16_t measurements = 50000;
+    unsigned long errors = 0;
+    for (uint16_t i = 0; i < measurements; i++)
+    {
+      sim.CO2 = i;
+      sim.TVOC = (uint16_t)~i;
+      sim.H2 = (uint16_t)(i * 3);
+      sim.ethanol = (uint16_t)~(i * 3);
+      if (mySensor.measureAirQuality() != SGP30_SUCCESS || mySensor.measureRawSignals() != SGP30_SUCCESS)
+        errors++;
+    }
+    running = false;
+    for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+    SGP30Snapshot last;
+    mySensor.readSnapshot(last);
+    failures += report("driver", stats, last.sequence);
+    if (errors || last.sequence != 2UL * measurements || last.CO2 != measurements - 1 || last.ethanol != (uint16_t)~((measurements - 1) * 3))
+    {
+      printf("FAIL: %lu measurement errors, last snapshot %lu\n", errors, (unsigned long)last.sequence);
+      failures++;
+    }
+
+    //A baseline read isn't a measurement: no snapshot stamped with its time,
+    //the baseline goes out with the next measurement
+    sim.baselineCO2 = 0x8123;
+    delay(100);
+    SGP30ERR error = mySensor.getBaseline();
+    SGP30Snapshot after;
+    mySensor.readSnapshot(after);
+    if (error != SGP30_SUCCESS || after.sequence != last.sequence || after.timestamp != last.timestamp)
+    {
+      printf("FAIL: getBaseline published a snapshot\n");
+      failures++;
+    }
+    mySensor.measureAirQuality();
+    mySensor.readSnapshot(after);
+    if (after.sequence != last.sequence + 1 || after.baselineCO2 != 0x8123)
+    {
+      printf("FAIL: baseline not published with the next measurement\n");
+      failures++;
+    }
+  }
+
+  if (failures)
+  {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
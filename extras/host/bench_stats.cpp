@@ -0,0 +1,103 @@
+/*
+  Host check of the driver's instrumentation counters.
+
+  Built with SGP30_ENABLE_STATS (see the Makefile). Runs every command
+  against the simulated SGP30 with injected faults, checks the counters
+  add up, prints the per-command table a telemetry push would carry and
+  the CPU time of measureAirQuality() with the counters compiled in
+  (compare with bench_methods, built without them).
+  Exits non-zero if any check fails.
+*/
+
+#include <stdio.h>
+#include <chrono>
+#include "Arduino.h"
+#include "HostCheck.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+#ifndef SGP30_ENABLE_STATS
+#error bench_stats needs SGP30_ENABLE_STATS
+#endif
+
+static const char *names[SGP30_COMMANDS] = {
+    "init_air_quality", "measure_air_quality", "get_baseline", "set_baseline", "set_humidity",
+    "measure_test", "get_feature_set_version", "get_serial_id", "measure_raw_signals",
+    "get_tvoc_inceptive_baseline", "set_tvoc_baseline"};
+
+int main(void)
+{
+  SGP30Sim sim;
+  SGP30 mySensor;
+  Wire.setClock(400000);
+  Wire.attach(0x58, &sim);
+  CHECK(mySensor.begin(Wire));
+  mySensor.initAirQuality();
+  delay(10);
+
+  for (int i = 0; i < 100; i++)
+    mySensor.measureAirQuality();
+  sim.badCRCs = 3;
+  for (int i = 0; i < 3; i++)
+    CHECK(mySensor.measureAirQuality() == SGP30_ERR_BAD_CRC);
+  sim.nackReads = 2;
+  for (int i = 0; i < 2; i++)
+    CHECK(mySensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT);
+  sim.nackWrites = 1;
+  CHECK(mySensor.measureAirQuality() == SGP30_ERR_I2C_TIMEOUT); //NACKed command, nothing is read
+  mySensor.getBaseline();
+  mySensor.setBaseline(0x8A3C, 0x8E12);
+  delay(10);
+  mySensor.setHumidity(0x0F80);
+  delay(10);
+  mySensor.getFeatureSetVersion();
+  mySensor.measureRawSignals();
+  mySensor.measureTest();
+
+  //Split phase: latency runs from the start to the end of the read
+  mySensor.startAirQuality();
+  delay(50);
+  CHECK(mySensor.readAirQuality() == SGP30_SUCCESS);
+
+  SGP30Stats snapshot;
+  mySensor.snapshotStats(snapshot, true);
+  printf("%-24s %6s %6s %8s %8s %8s %8s\n", "command", "calls", "crc", "timeout", "min us", "avg us", "max us");
+  for (uint8_t c = 0; c < SGP30_COMMANDS; c++)
+  {
+    const SGP30CommandStats &command = snapshot.commands[c];
+    printf("%-24s %6lu %6lu %8lu %8lu %8lu %8lu\n", names[c], (unsigned long)command.calls,
+           (unsigned long)command.badCRC, (unsigned long)command.timeouts, (unsigned long)command.latencyMin,
+           (unsigned long)command.latencyAverage(), (unsigned long)command.latencyMax);
+  }
+  printf("bytes sent %lu, received %lu\n", (unsigned long)snapshot.bytesSent, (unsigned long)snapshot.bytesReceived);
+
+  const SGP30CommandStats &airQuality = snapshot.commands[SGP30_CMD_MEASURE_AIR_QUALITY];
+  CHECK(airQuality.calls == 107);
+  CHECK(airQuality.badCRC == 3);
+  CHECK(airQuality.timeouts == 3);
+  CHECK(airQuality.completed == 101);
+  CHECK(airQuality.latencyMin >= 12000 && airQuality.latencyMin < 13000);
+  CHECK(airQuality.latencyMax >= 50000);
+  CHECK(snapshot.commands[SGP30_CMD_GET_SERIAL_ID].calls == 1);
+  CHECK(snapshot.commands[SGP30_CMD_INIT_AIR_QUALITY].completed == 1);
+  CHECK(snapshot.commands[SGP30_CMD_SET_BASELINE].calls == 1 && snapshot.commands[SGP30_CMD_SET_BASELINE].completed == 1);
+  CHECK(snapshot.commands[SGP30_CMD_MEASURE_TEST].latencyMin >= 220000);
+  //Every frame is 2 command bytes plus 3 per parameter word, and 3 per response word
+  //begin() reads the serial ID and the feature set
+  CHECK(snapshot.bytesSent == 2 * (2 + 1 + 106 + 1 + 1 + 1 + 1 + 1 + 1) + 6 + 3);
+  CHECK(snapshot.bytesReceived == 3 * (3 + 1 + 2 * 104 + 2 + 1 + 2 + 1));
+
+  //Reset by the snapshot
+  CHECK(mySensor.stats().commands[SGP30_CMD_MEASURE_AIR_QUALITY].calls == 0);
+  CHECK(mySensor.stats().bytesSent == 0);
+
+  const int iterations = 100000;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    mySensor.measureAirQuality();
+  double cpuNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+  printf("measureAirQuality with stats: %.1f cpu ns/call\n", cpuNs);
+
+  return checkSummary();
+}
@@ -0,0 +1,85 @@
+/*
+  Reads a real SGP30 on a Linux i2c-dev bus, e.g. a Raspberry Pi gateway.
+
+    sgp30_linux [device] [seconds]     default /dev/i2c-1, run until 'q' or EOF
+
+  Shows the driver running from a poll() event loop: a measurement is
+  started every second, poll() waits on stdin with msUntilReady() (or the
+  time to the next second) as its timeout, and the result is read once the
+  sensor is done. Nothing blocks except the transfers themselves, one
+  ioctl(I2C_RDWR) per frame.
+
+  Built with the monotonic clock (-DHOST_REAL_CLOCK), see the Makefile.
+*/
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Arduino.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_LinuxI2C.h"
+
+int main(int argc, char **argv)
+{
+  const char *device = argc > 1 ? argv[1] : "/dev/i2c-1";
+  unsigned long seconds = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+
+  SGP30LinuxI2C bus;
+  if (!bus.begin(device))
+  {
+    fprintf(stderr, "%s: %s\n", device, strerror(errno));
+    return 1;
+  }
+  SGP30 mySensor;
+  if (!mySensor.begin(bus))
+  {
+    fprintf(stderr, "No SGP30 detected on %s\n", device);
+    return 1;
+  }
+  printf("SGP30 serial ID 0x%012llX\n", (unsigned long long)mySensor.serialID);
+  mySensor.initAirQuality();
+  delay(10); //init takes up to 10ms
+
+  unsigned long next = millis();
+  unsigned long measurements = 0;
+  unsigned long syscalls = bus.syscalls;
+  bool input = true;
+  while (seconds == 0 || measurements < seconds)
+  {
+    if (!mySensor.isBusy() && (long)(millis() - next) >= 0)
+    {
+      next += 1000; //keep the 1 second cadence, not 1 second after we got here
+      if (mySensor.startAirQuality() != SGP30_SUCCESS)
+        fprintf(stderr, "start failed\n");
+    }
+    if (mySensor.isBusy() && mySensor.isReady())
+    {
+      if (mySensor.readAirQuality() == SGP30_SUCCESS)
+        printf("CO2: %u ppm\tTVOC: %u ppb\t(%lu ioctl)\n", mySensor.CO2, mySensor.TVOC, bus.syscalls - syscalls);
+      else
+        fprintf(stderr, "read failed\n");
+      syscalls = bus.syscalls;
+      measurements++;
+      fflush(stdout);
+    }
+
+    //Sleep until the sensor is done, the next second or input
+    long timeout = mySensor.isBusy() ? (long)mySensor.msUntilReady() : (long)(next - millis());
+    if (timeout < 0)
+      timeout = 0;
+    struct pollfd fds = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&fds, input ? 1 : 0, (int)timeout) > 0)
+    {
+      char ch;
+      ssize_t got = read(STDIN_FILENO, &ch, 1);
+      if (got == 1 && (ch == 'q' || ch == 'Q'))
+        break;
+      if (got <= 0)
+        input = false; //stdin closed, keep measuring on the timer alone
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,393 @@
+/*
+  Decoder and benchmark for the SGP30 binary log (SparkFun_SGP30_Log.h).
+
+    sgp30_log decode [file]     stream (default stdin) to CSV on stdout
+    sgp30_log [bench] [file]    checks and numbers below, optionally saves the
+                                generated stream to file for decode
+
+  The benchmark logs 24 hours of simulated 1 Hz samples and reports the
+  compression ratio against the text the examples print and against plain
+  CSV, and the encode cost per sample. It checks that every sample decodes
+  exactly, that a stream truncated mid-frame (power loss) and followed by a
+  new one loses nothing but the cut frame, and that damaged bytes never
+  produce a wrong sample and lose at most a keyframe interval. Exits
+  non-zero if a check fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "Arduino.h"
+#include "HostCheck.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_Log.h"
+
+//Print that keeps everything in memory
+class MemoryPrint : public Print
+{
+public:
+  std::vector<uint8_t> data;
+  size_t write(uint8_t value) { data.push_back(value); return 1; }
+  size_t write(const uint8_t *buffer, size_t size)
+  {
+    data.insert(data.end(), buffer, buffer + size);
+    return size;
+  }
+};
+
+struct Row
+{
+  uint64_t serialID;
+  uint16_t featureSetVersion;
+  SGP30Sample sample;
+};
+
+//Frame parser, resynchronizes on the next sync byte with a valid CRC
+class LogDecoder
+{
+public:
+  unsigned long frames;  //valid frames
+  unsigned long skipped; //bytes skipped while out of sync
+  unsigned long resyncs; //times sync was lost
+  unsigned long orphans; //valid delta frames dropped for lack of a keyframe
+
+  void decode(const uint8_t *data, size_t size, std::vector<Row> &rows)
+  {
+    frames = skipped = resyncs = orphans = 0;
+    bool haveHeader = false, haveKey = false, chained = false, inSync = true;
+    uint8_t chain = 0;
+    uint16_t period = 1000;
+    Row row;
+    memset(&row, 0, sizeof(row));
+    size_t pos = 0;
+    while (pos + SGP30_LOG_FRAMING <= size)
+    {
+      const uint8_t *frame = data + pos;
+      uint8_t type = frame[1], length = frame[2];
+      bool valid = frame[0] == SGP30_LOG_SYNC && type >= SGP30_LOG_HEADER && type <= SGP30_LOG_DELTA &&
+                   pos + SGP30_LOG_FRAMING + length <= size;
+      if (valid)
+      {
+        uint8_t crc;
+        if (type == SGP30_LOG_DELTA)
+        {
+          uint8_t buffer[3 + 255];
+          buffer[0] = chain;
+          memcpy(buffer + 1, frame + 1, length + 2);
+          crc = sgp30CRC8(buffer, length + 3);
+        }
+        else
+          crc = sgp30CRC8(frame + 1, length + 2);
+        valid = crc == frame[3 + length];
+        if (valid && type == SGP30_LOG_DELTA && !chained)
+        {
+          orphans++; //genuine, but what it is relative to was lost
+          valid = false;
+        }
+        const uint8_t *payload = frame + 3, *end = payload + length;
+        if (valid && type == SGP30_LOG_HEADER)
+        {
+          uint32_t featureSetVersion, value;
+          valid = length >= 7 && payload[0] == SGP30_LOG_VERSION;
+          const uint8_t *p = payload + 7;
+          if (valid && _varint(&p, end, &featureSetVersion) && _varint(&p, end, &value) && p == end)
+          {
+            row.serialID = 0;
+            for (uint8_t i = 1; i < 7; i++)
+              row.serialID = (row.serialID << 8) | payload[i];
+            row.featureSetVersion = (uint16_t)featureSetVersion;
+            period = (uint16_t)value;
+            haveHeader = true;
+            haveKey = false; //a header always comes right before its keyframe
+          }
+          else
+            valid = false;
+        }
+        else if (valid && type == SGP30_LOG_KEYFRAME)
+        {
+          uint32_t values[5];
+          const uint8_t *p = payload;
+          for (uint8_t i = 0; i < 5 && valid; i++)
+            valid = _varint(&p, end, &values[i]);
+          valid = valid && p == end;
+          if (valid && haveHeader)
+          {
+            row.sample.timestamp = values[0];
+            row.sample.CO2 = (uint16_t)values[1];
+            row.sample.TVOC = (uint16_t)values[2];
+            row.sample.H2 = (uint16_t)values[3];
+            row.sample.ethanol = (uint16_t)values[4];
+            rows.push_back(row);
+            haveKey = true;
+          }
+        }
+        else if (valid && type == SGP30_LOG_DELTA)
+        {
+          //Decode into a copy, a malformed payload must not emit half a frame
+          std::vector<Row> batch;
+          Row next = row;
+          const uint8_t *p = payload;
+          while (valid && p < end)
+          {
+            int32_t d[5];
+            for (uint8_t i = 0; i < 5 && valid; i++)
+              valid = _signed(&p, end, &d[i]);
+            if (!valid)
+              break;
+            next.sample.timestamp = (uint32_t)(next.sample.timestamp + period + d[0]);
+            next.sample.CO2 = (uint16_t)(next.sample.CO2 + d[1]);
+            next.sample.TVOC = (uint16_t)(next.sample.TVOC + d[2]);
+            next.sample.H2 = (uint16_t)(next.sample.H2 + d[3]);
+            next.sample.ethanol = (uint16_t)(next.sample.ethanol + d[4]);
+            batch.push_back(next);
+          }
+          valid = valid && !batch.empty();
+          if (valid)
+          {
+            rows.insert(rows.end(), batch.begin(), batch.end());
+            row = next;
+          }
+        }
+        if (valid)
+        {
+          chain = crc;
+          chained = haveKey;
+          frames++;
+          inSync = true;
+          pos += SGP30_LOG_FRAMING + length;
+          continue;
+        }
+      }
+      if (inSync)
+        resyncs++;
+      inSync = false;
+      chained = false; //an 8 bit chain can't vouch for every delta after a gap
+      skipped++;
+      pos++;
+    }
+    skipped += size - pos; //truncated tail
+  }
+
+private:
+  static bool _varint(const uint8_t **p, const uint8_t *end, uint32_t *value)
+  {
+    *value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+      if (*p >= end)
+        return false;
+      uint8_t byte = *(*p)++;
+      *value |= (uint32_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  static bool _signed(const uint8_t **p, const uint8_t *end, int32_t *value)
+  {
+    uint32_t zigzag;
+    if (!_varint(p, end, &zigzag))
+      return false;
+    *value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+    return true;
+  }
+};
+
+static std::vector<uint8_t> readAll(FILE *file)
+{
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t got;
+  while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    data.insert(data.end(), buffer, buffer + got);
+  return data;
+}
+
+static int decode(const char *path)
+{
+  FILE *file = path ? fopen(path, "rb") : stdin;
+  if (file == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+  std::vector<uint8_t> data = readAll(file);
+  if (path)
+    fclose(file);
+  std::vector<Row> rows;
+  LogDecoder decoder;
+  decoder.decode(data.data(), data.size(), rows);
+  printf("serial_id,feature_set,timestamp_ms,co2_ppm,tvoc_ppb,h2_raw,ethanol_raw\n");
+  for (size_t i = 0; i < rows.size(); i++)
+  {
+    const Row &r = rows[i];
+    printf("%012llX,0x%04X,%lu,%u,%u,%u,%u\n", (unsigned long long)r.serialID, r.featureSetVersion,
+           (unsigned long)r.sample.timestamp, r.sample.CO2, r.sample.TVOC, r.sample.H2, r.sample.ethanol);
+  }
+  fprintf(stderr, "%zu bytes, %lu frames, %zu samples, %lu bytes skipped in %lu resync(s)\n",
+          data.size(), decoder.frames, rows.size(), decoder.skipped, decoder.resyncs);
+  return 0;
+}
+
+//Slowly drifting indoor signals with a little noise and timer jitter
+static std::vector<SGP30Sample> simulate(unsigned long count, unsigned long start, uint32_t seed)
+{
+  std::vector<SGP30Sample> samples;
+  SGP30Sample s = {start, 400, 0, 13600, 18200};
+  for (unsigned long i = 0; i < count; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    int wave = (int)((i / 60) % 240) < 120 ? 1 : -1; //occupancy, up then down
+    s.timestamp += 1000 + (seed >> 16) % 4;
+    s.CO2 = (uint16_t)std::max(400, (int)s.CO2 + ((seed >> 8) % 7 == 0 ? wave : 0) + (int)((seed >> 20) % 3) - 1);
+    s.TVOC = (uint16_t)std::max(0, (int)s.TVOC + ((seed >> 11) % 5 == 0 ? wave : 0) + (int)((seed >> 24) % 3) - 1);
+    s.H2 = (uint16_t)(s.H2 + (int)((seed >> 4) % 5) - 2);
+    s.ethanol = (uint16_t)(s.ethanol + (int)((seed >> 14) % 5) - 2);
+    samples.push_back(s);
+  }
+  return samples;
+}
+
+static std::vector<uint8_t> encode(const std::vector<SGP30Sample> &samples, uint8_t batch, double *ns = NULL)
+{
+  MemoryPrint out;
+  out.data.reserve(samples.size() * 8);
+  SGP30LogEncoder encoder(out);
+  encoder.begin(0x0000019AF2B1ULL, 0x0022);
+  encoder.setBatch(batch);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < samples.size(); i++)
+    encoder.write(samples[i]);
+  encoder.flush();
+  if (ns)
+    *ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples.size();
+  CHECK(encoder.bytes == out.data.size());
+  CHECK(encoder.samples == samples.size());
+  return out.data;
+}
+
+static bool same(const SGP30Sample &a, const SGP30Sample &b)
+{
+  return (uint32_t)a.timestamp == (uint32_t)b.timestamp && a.CO2 == b.CO2 && a.TVOC == b.TVOC &&
+         a.H2 == b.H2 && a.ethanol == b.ethanol;
+}
+
+//Every decoded row must be one of the originals, in order; returns how many were lost
+static size_t matchAll(const std::vector<Row> &rows, const std::vector<SGP30Sample> &samples, size_t *wrong)
+{
+  size_t next = 0;
+  *wrong = 0;
+  for (size_t r = 0; r < rows.size(); r++)
+  {
+    while (next < samples.size() && (uint32_t)samples[next].timestamp < (uint32_t)rows[r].sample.timestamp)
+      next++;
+    if (next < samples.size() && same(samples[next], rows[r].sample))
+      next++;
+    else
+      (*wrong)++;
+  }
+  return samples.size() - (rows.size() - *wrong);
+}
+
+static int bench(const char *path)
+{
+  const unsigned long count = 24UL * 3600;
+  std::vector<SGP30Sample> samples = simulate(count, 5000, 1);
+
+  //Text the examples print, and plain CSV
+  size_t text = 0, csv = 0;
+  char line[96];
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    const SGP30Sample &s = samples[i];
+    text += snprintf(line, sizeof(line), "CO2: %u ppm\tTVOC: %u ppb\tRaw H2: %u \tRaw Ethanol: %u\r\n", s.CO2, s.TVOC, s.H2, s.ethanol);
+    csv += snprintf(line, sizeof(line), "%lu,%u,%u,%u,%u\n", (unsigned long)s.timestamp, s.CO2, s.TVOC, s.H2, s.ethanol);
+  }
+  printf("%lu samples: text %zu bytes, csv %zu bytes\n", count, text, csv);
+
+  LogDecoder decoder;
+  std::vector<uint8_t> stream;
+  const uint8_t batches[] = {1, 4, SGP30_LOG_MAX_BATCH};
+  for (uint8_t b = 0; b < sizeof(batches); b++)
+  {
+    double ns;
+    std::vector<uint8_t> data = encode(samples, batches[b], &ns);
+    printf("batch %u: %zu bytes, %.2f bytes/sample, %.1fx vs text, %.1fx vs csv, encode %.1f ns/sample\n",
+           batches[b], data.size(), (double)data.size() / count, (double)text / data.size(), (double)csv / data.size(), ns);
+    std::vector<Row> rows;
+    decoder.decode(data.data(), data.size(), rows);
+    CHECK(rows.size() == count);
+    CHECK(decoder.skipped == 0 && decoder.resyncs == 0);
+    bool exact = rows.size() == count;
+    for (size_t i = 0; exact && i < count; i++)
+      exact = same(rows[i].sample, samples[i]) && rows[i].serialID == 0x0000019AF2B1ULL && rows[i].featureSetVersion == 0x0022;
+    CHECK(exact);
+    if (b == 0)
+      stream = data;
+  }
+
+  //Power loss: the stream is cut mid-frame and the logger starts a new one
+  std::vector<SGP30Sample> after = simulate(600, samples.back().timestamp + 20000, 2);
+  std::vector<uint8_t> resumed = encode(after, 1);
+  size_t cut = stream.size() / 2 + 3;
+  std::vector<uint8_t> truncated(stream.begin(), stream.begin() + cut);
+  truncated.insert(truncated.end(), resumed.begin(), resumed.end());
+  std::vector<SGP30Sample> both = samples;
+  both.insert(both.end(), after.begin(), after.end());
+  std::vector<Row> rows;
+  decoder.decode(truncated.data(), truncated.size(), rows);
+  size_t wrong, lost = matchAll(rows, both, &wrong);
+  size_t tail = count - (rows.size() - after.size());
+  printf("truncated at byte %zu: %zu samples lost (%zu after the cut), %lu bytes skipped\n", cut, lost, tail, decoder.skipped);
+  CHECK(wrong == 0);
+  CHECK(lost == tail);                //only what was after the cut
+  CHECK(rows.size() >= count / 2 - 2); //everything before it
+  CHECK(!rows.empty() && same(rows.back().sample, after.back()));
+
+  //Damage: single bytes overwritten all along the stream
+  uint32_t seed = 7;
+  size_t worstLost = 0, totalWrong = 0, trials = 2000;
+  for (size_t t = 0; t < trials; t++)
+  {
+    std::vector<uint8_t> damaged = stream;
+    seed = seed * 1103515245 + 12345;
+    size_t at = (seed >> 4) % damaged.size();
+    damaged[at] ^= (uint8_t)(1 + (seed >> 20) % 255);
+    rows.clear();
+    decoder.decode(damaged.data(), damaged.size(), rows);
+    lost = matchAll(rows, samples, &wrong);
+    totalWrong += wrong;
+    if (lost > worstLost)
+      worstLost = lost;
+  }
+  printf("%zu damaged streams: worst loss %zu samples, %zu wrong samples\n", trials, worstLost, totalWrong);
+  CHECK(totalWrong == 0);
+  CHECK(worstLost <= 60); //the rest of the damaged keyframe interval
+
+  if (path)
+  {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL || fwrite(stream.data(), 1, stream.size(), file) != stream.size())
+    {
+      perror(path);
+      failures++;
+    }
+    if (file)
+      fclose(file);
+  }
+
+  return checkSummary();
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && strcmp(argv[1], "decode") == 0)
+    return decode(argc > 2 ? argv[2] : NULL);
+  if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    return bench(argc > 2 ? argv[2] : NULL);
+  return bench(argc > 1 ? argv[1] : NULL);
+}
@@ -0,0 +1,372 @@
+/*
+  Bus trace dump and replay benchmark (SparkFun_SGP30_Trace.h, SGP30Replay.h).
+
+    sgp30_trace dump [file]     trace (default stdin) as one line per transaction
+    sgp30_trace [bench] [file]  checks and numbers below, optionally saves the
+                                recorded trace to file for dump
+
+  The benchmark records 24 hours of an application measuring the simulated
+  sensor at 1 Hz, with raw signals, baseline reads, humidity updates, a
+  history, alert rules and fault recovery, while the simulation injects bus
+  faults. It then replays the trace through a fresh, unmodified driver
+  running the same application without any device, and checks that every
+  result, error and timestamp comes out the same. It reports the trace
+  size, the replay speed against real time and the parse speed, and checks
+  that a driver that behaves differently, or a trace cut short, is caught
+  as a divergence. Exits non-zero if a check fails.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "Arduino.h"
+#include "HostCheck.h"
+#include "Wire.h"
+#include "SGP30Sim.h"
+#include "SGP30Replay.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_Recovery.h"
+
+//Print that keeps everything in memory
+class MemoryPrint : public Print
+{
+public:
+  std::vector<uint8_t> data;
+  size_t write(uint8_t value) { data.push_back(value); return 1; }
+  size_t write(const uint8_t *buffer, size_t size)
+  {
+    data.insert(data.end(), buffer, buffer + size);
+    return size;
+  }
+};
+
+//What the application saw after each measurement
+struct Result
+{
+  unsigned long time;
+  SGP30ERR error;
+  uint16_t CO2;
+  uint16_t TVOC;
+  uint16_t H2;
+  uint16_t ethanol;
+  uint16_t baselineCO2;
+  uint16_t baselineTVOC;
+  uint8_t alerts;
+
+  bool operator==(const Result &other) const
+  {
+    return time == other.time && error == other.error && CO2 == other.CO2 && TVOC == other.TVOC &&
+           H2 == other.H2 && ethanol == other.ethanol && baselineCO2 == other.baselineCO2 &&
+           baselineTVOC == other.baselineTVOC && alerts == other.alerts;
+  }
+};
+
+static unsigned long alertChanges;
+
+static void changed(uint8_t rule, bool active, const SGP30Sample &sample, void *context)
+{
+  (void)rule;
+  (void)active;
+  (void)sample;
+  (void)context;
+  alertChanges++;
+}
+
+//Air the simulated sensor sees at second i, with a bus fault now and then
+static void weather(SGP30Sim &sim, unsigned long i)
+{
+  sim.CO2 = (uint16_t)(600 + (i * 7 % 3600) / 4 + (i % 13));
+  sim.TVOC = (uint16_t)((i / 600) % 2 ? 50 + (i % 600) : 40 + (i % 5));
+  sim.H2 = (uint16_t)(13000 + (i * 31 % 97));
+  sim.ethanol = (uint16_t)(18000 - (i * 17 % 89));
+  if (i % 997 == 500)
+    sim.badCRCs = 1;
+  if (i % 1499 == 700)
+    sim.nackReads = 1;
+  if (i % 21601 == 10000)
+    sim.nackWrites = 3; //enough failed readings in a row to re-initialize
+}
+
+//The same application records with sim and replays without it
+//humidityStep changes what the driver sends, to check divergence
+static unsigned long application(SGP30 &sensor, SGP30Transport &transport, SGP30Sim *sim, unsigned long seconds,
+                                 std::vector<Result> &results, SGP30Recovery &recovery, uint16_t humidityStep = 0x80)
+{
+  SGP30History<60> history;
+  SGP30Alerts<2> alerts;
+  alerts.addAbove(SGP30_SIGNAL_CO2, 1200, 1000, changed);
+  alerts.addRising(SGP30_SIGNAL_TVOC, 200, 50, 60000, changed);
+  sensor.attachHistory(history);
+  sensor.attachAlerts(alerts);
+  sensor.attachRecovery(recovery);
+  alertChanges = 0;
+  if (!sensor.begin(transport))
+    return 0;
+  sensor.initAirQuality();
+  delay(10);
+  unsigned long next = millis();
+  unsigned long measurements = 0;
+  for (unsigned long i = 0; i < seconds; i++)
+  {
+    next += 1000;
+    if ((long)(uint32_t)(next - millis()) > 0)
+      delay((uint32_t)(next - millis()));
+    if (sim)
+      weather(*sim, i);
+    Result result;
+    memset(&result, 0, sizeof(result));
+    result.time = millis();
+    result.error = sensor.measureAirQuality();
+    measurements++;
+    if (i % 60 == 59)
+    {
+      SGP30ERR error = sensor.measureRawSignals();
+      if (error != SGP30_SUCCESS)
+        result.error = error;
+    }
+    if (i % 3600 == 1800)
+      sensor.getBaseline();
+    if (i % 600 == 300)
+    {
+      sensor.setHumidity((uint16_t)(0x0800 + (i / 600) * humidityStep));
+      delay(10);
+    }
+    result.CO2 = sensor.CO2;
+    result.TVOC = sensor.TVOC;
+    result.H2 = sensor.H2;
+    result.ethanol = sensor.ethanol;
+    result.baselineCO2 = sensor.baselineCO2;
+    result.baselineTVOC = sensor.baselineTVOC;
+    result.alerts = (alerts.active(0) ? 1 : 0) | (alerts.active(1) ? 2 : 0);
+    results.push_back(result);
+  }
+  sensor.detachAlerts(alerts);
+  sensor.detachHistory(history);
+  sensor.detachRecovery(recovery);
+  return measurements;
+}
+
+static void checkRecorder(void)
+{
+  //Nothing to pass transactions on to
+  MemoryPrint output;
+  SGP30TraceRecorder recorder(output);
+  uint8_t data[6] = {0x20, 0x08};
+  CHECK(!recorder.write(0x58, data, 2));
+  CHECK(!recorder.read(0x58, data, 6));
+  CHECK(recorder.transactions == 2);
+
+  //Header, a failed write with its bytes, a failed read without
+  SGP30TraceReader reader;
+  CHECK(reader.begin(output.data.data(), output.data.size()));
+  SGP30TraceRecord record;
+  CHECK(reader.next(record) && !record.read && record.failed && record.length == 2 && record.data[1] == 0x08);
+  CHECK(reader.next(record) && record.read && record.failed && record.length == 6 && record.data == NULL);
+  CHECK(!reader.next(record) && !reader.truncated());
+  CHECK(output.data.size() == SGP30_TRACE_HEADER + 4 + 2);
+
+  //Other addresses and long transactions
+  SGP30MemoryTransport memory;
+  recorder.setTransport(memory);
+  recorder.begin();
+  output.data.clear();
+  uint8_t reset = 0x06;
+  uint8_t big[40];
+  for (uint8_t i = 0; i < sizeof(big); i++)
+    big[i] = i;
+  CHECK(recorder.write(0x00, &reset, 1));
+  delay(70000);
+  CHECK(recorder.write(0x58, big, sizeof(big)));
+  CHECK(reader.begin(output.data.data(), output.data.size()));
+  CHECK(reader.next(record) && record.address == 0x00 && record.length == 1 && record.data[0] == 0x06);
+  uint64_t first = record.time;
+  CHECK(reader.next(record) && record.address == 0x58 && record.length == 40 && record.data[39] == 39);
+  CHECK(record.time - first == 70000);
+  CHECK(reader.position() == output.data.size());
+
+  //Not a trace
+  uint8_t junk[SGP30_TRACE_HEADER] = {'S', 'G', 'X', 1};
+  CHECK(!reader.begin(junk, sizeof(junk)));
+  SGP30Replay replay;
+  CHECK(!replay.begin(junk, sizeof(junk)));
+}
+
+static bool sameResults(const std::vector<Result> &a, const std::vector<Result> &b, size_t count)
+{
+  if (a.size() < count || b.size() < count)
+    return false;
+  for (size_t i = 0; i < count; i++)
+    if (!(a[i] == b[i]))
+      return false;
+  return true;
+}
+
+static int bench(const char *path)
+{
+  checkRecorder();
+
+  //Record
+  const unsigned long seconds = 24UL * 3600;
+  SGP30Sim sim;
+  Wire.attach(0x58, &sim);
+  hostSetMicros(123456789ULL);
+  SGP30TwoWireTransport wire(Wire);
+  MemoryPrint output;
+  SGP30TraceRecorder recorder(output);
+  std::vector<Result> recorded;
+  SGP30Recovery recordedRecovery;
+  {
+    SGP30 sensor;
+    sensor.attachRecorder(recorder); //before begin(), which puts it in front of wire
+    application(sensor, wire, &sim, seconds, recorded, recordedRecovery);
+  }
+  Wire.detachAll();
+  const std::vector<uint8_t> &trace = output.data;
+  CHECK(recorded.size() == seconds);
+  CHECK(recorder.bytes == trace.size());
+  CHECK(recordedRecovery.recoveries > 0 && recordedRecovery.retried > 0);
+  size_t errors = 0;
+  for (size_t i = 0; i < recorded.size(); i++)
+    if (recorded[i].error != SGP30_SUCCESS && recorded[i].error != SGP30_ERR_NOT_READY) //not held by recovery
+      errors++;
+  CHECK(errors > 0);
+  printf("%lu s recorded: %lu transactions, %zu bytes, %.2f bytes/measurement, %.0f kB/day, %zu failed readings, %lu recoveries\n",
+         seconds, recorder.transactions, trace.size(), (double)trace.size() / seconds, trace.size() / 1024.0,
+         errors, recordedRecovery.recoveries);
+
+  //Parse
+  SGP30TraceReader reader;
+  SGP30TraceRecord record;
+  unsigned long records = 0;
+  bool generalCall = false;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < 20; pass++)
+  {
+    reader.begin(trace.data(), trace.size());
+    while (reader.next(record))
+    {
+      records++;
+      generalCall |= record.address == 0x00;
+    }
+  }
+  double parseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  CHECK(records == 20 * recorder.transactions);
+  CHECK(generalCall); //the recovery's reset
+  CHECK(!reader.truncated());
+
+  //Replay through a fresh driver, no device on the bus
+  SGP30Replay replay;
+  std::vector<Result> replayed;
+  SGP30Recovery replayedRecovery;
+  start = std::chrono::steady_clock::now();
+  {
+    SGP30 sensor;
+    CHECK(replay.begin(trace.data(), trace.size()));
+    application(sensor, replay, NULL, seconds, replayed, replayedRecovery);
+  }
+  double replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  CHECK(!replay.diverged);
+  CHECK(replay.finished());
+  CHECK(replay.transactions == recorder.transactions);
+  CHECK(replayed.size() == recorded.size());
+  CHECK(sameResults(recorded, replayed, recorded.size()));
+  CHECK(replayedRecovery.recoveries == recordedRecovery.recoveries);
+  CHECK(replayedRecovery.retried == recordedRecovery.retried);
+  printf("replay: %.0f measurements/s, %.0fx real time; parse: %.1f M records/s, %.0f MB/s\n",
+         seconds / replaySeconds, seconds / replaySeconds, records / parseSeconds / 1e6,
+         20.0 * trace.size() / parseSeconds / 1e6);
+
+  //A driver that sends something else is caught where it first differs
+  std::vector<Result> different;
+  SGP30Recovery differentRecovery;
+  {
+    SGP30 sensor;
+    replay.begin(trace.data(), trace.size());
+    application(sensor, replay, NULL, 3600, different, differentRecovery, 0x40);
+  }
+  CHECK(replay.diverged && !replay.finished());
+  CHECK(!replay.expected.read && replay.expected.length == 5 && replay.expected.data[1] == 0x61); //set_humidity
+  CHECK(sameResults(recorded, different, 300));
+  printf("changed humidity steps: diverged at transaction %lu\n", replay.divergedAt);
+
+  //Cut short: the same results up to the cut, then the driver runs out of trace
+  size_t cut = trace.size() / 2 + 5;
+  std::vector<Result> shortened;
+  SGP30Recovery shortenedRecovery;
+  {
+    SGP30 sensor;
+    replay.begin(trace.data(), cut);
+    application(sensor, replay, NULL, seconds, shortened, shortenedRecovery);
+  }
+  CHECK(replay.diverged);
+  size_t same = 0;
+  while (same < shortened.size() && shortened[same] == recorded[same])
+    same++;
+  CHECK(same >= seconds / 2 - 60 && same < seconds);
+  CHECK(shortened.back().error != SGP30_SUCCESS);
+  printf("trace cut at byte %zu: %zu of %lu measurements replayed\n", cut, same, seconds);
+
+  if (path)
+  {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL || fwrite(trace.data(), 1, trace.size(), file) != trace.size())
+    {
+      perror(path);
+      failures++;
+    }
+    if (file)
+      fclose(file);
+  }
+
+  return checkSummary();
+}
+
+//One line per transaction: ms since the start, address, W/R, ok/NACK, bytes
+static int dump(const char *path)
+{
+  FILE *file = path ? fopen(path, "rb") : stdin;
+  if (file == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+  std::vector<uint8_t> trace;
+  uint8_t buffer[4096];
+  size_t got;
+  while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    trace.insert(trace.end(), buffer, buffer + got);
+  if (path)
+    fclose(file);
+
+  SGP30TraceReader reader;
+  if (!reader.begin(trace.data(), trace.size()))
+  {
+    fprintf(stderr, "not an SGP30 trace\n");
+    return 1;
+  }
+  SGP30TraceRecord record;
+  while (reader.next(record))
+  {
+    printf("%llu 0x%02X %c %s", (unsigned long long)(record.time - reader.start), record.address,
+           record.read ? 'R' : 'W', record.failed ? "NACK" : "ok");
+    for (uint8_t i = 0; record.data != NULL && i < record.length; i++)
+      printf(" %02X", record.data[i]);
+    printf("\n");
+  }
+  if (reader.truncated())
+  {
+    fprintf(stderr, "trace cut short at byte %zu\n", reader.position());
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && strcmp(argv[1], "dump") == 0)
+    return dump(argc > 2 ? argv[2] : NULL);
+  if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    return bench(argc > 2 ? argv[2] : NULL);
+  return bench(argc > 1 ? argv[1] : NULL);
+}
@@ -0,0 +1,66 @@
+/*
+  Sketch built once per configuration by make sizes, with
+  -DSGP30_SIZE_CONFIG=0..3, to measure the flash and RAM the driver takes:
+    0  BasicSGP30<>: begin, initAirQuality, measureAirQuality
+    1  BasicSGP30<SGP30Baselines, SGP30HumidityCompensation>: also
+       getBaseline, setBaseline, setRelativeHumidity
+    2  BasicSGP30<SGP30_ALL_FEATURES>: every method
+    3  SGP30: the calls of configuration 1
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_Basic.h"
+
+#if SGP30_SIZE_CONFIG == 0
+BasicSGP30<> mySensor;
+#elif SGP30_SIZE_CONFIG == 1
+BasicSGP30<SGP30Baselines, SGP30HumidityCompensation> mySensor;
+#elif SGP30_SIZE_CONFIG == 2
+BasicSGP30<SGP30_ALL_FEATURES> mySensor;
+#else
+SGP30 mySensor;
+#endif
+
+//Keeps the results from being optimized away
+volatile uint32_t sink;
+
+int main(void)
+{
+  if (!mySensor.begin(Wire))
+    return 1;
+  mySensor.initAirQuality();
+  sink = mySensor.measureAirQuality();
+  sink = mySensor.CO2 + mySensor.TVOC;
+#if SGP30_SIZE_CONFIG != 0
+  sink = mySensor.getBaseline();
+  mySensor.setBaseline(mySensor.baselineCO2, mySensor.baselineTVOC);
+  sink = mySensor.setRelativeHumidity(2500, 5000);
+#endif
+#if SGP30_SIZE_CONFIG == 2
+  sink = mySensor.startAirQuality();
+  sink = mySensor.readAirQuality();
+  sink = mySensor.measureRawSignals();
+  sink = mySensor.startRawSignals();
+  sink = mySensor.readRawSignals();
+  sink = mySensor.H2 + mySensor.ethanol;
+  sink = mySensor.getSerialID();
+  sink = mySensor.startSerialID();
+  sink = mySensor.readSerialID();
+  sink = (uint32_t)mySensor.serialID;
+  sink = mySensor.getFeatureSetVersion();
+  sink = mySensor.startFeatureSetVersion();
+  sink = mySensor.readFeatureSetVersion();
+  sink = mySensor.featureSetVersion;
+  sink = mySensor.measureTest();
+  sink = mySensor.startTest();
+  sink = mySensor.readTest();
+  sink = mySensor.startBaseline();
+  sink = mySensor.readBaseline();
+  mySensor.setHumidity(0);
+  mySensor.setHumidityHysteresis(0);
+  mySensor.generalCallReset();
+#endif
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Alert rules evaluated on every reading, see SparkFun_SGP30_Alerts.h
+*/
+
+#include "SparkFun_SGP30_Alerts.h"
+
+//SGP30Rule flags
+#define SGP30_RULE_ACTIVE 0x01
+#define SGP30_RULE_SLOPE 0x02   //on the slope rather than the value
+#define SGP30_RULE_NEGATE 0x04  //below / falling: compares -value, so every rule triggers upwards
+#define SGP30_RULE_PRIMED 0x08  //slope: previous and last hold a reading
+
+//Limit of a rule's change, leaves room to add a reading's change to it
+#define SGP30_CHANGE_LIMIT 0x3FFFFFFFL
+
+//x * num / den without 64 bit arithmetic, which small cores emulate at a
+//high price: num and den keep their top 16 bits, saturates at 2^31 - 1
+static uint32_t _scale(uint32_t x, uint32_t num, uint32_t den)
+{
+  while (num > 0xFFFF || den > 0xFFFF)
+  {
+    num >>= 1;
+    den >>= 1;
+  }
+  if (den == 0)
+    return 0x7FFFFFFF;
+  uint32_t whole = x / den;
+  if (num != 0 && whole > 0x7FFFFFFF / num)
+    return 0x7FFFFFFF;
+  uint32_t result = whole * num + (x % den) * num / den;
+  return result > 0x7FFFFFFF ? 0x7FFFFFFF : result;
+}
+
+//Same on a signed x
+static int32_t _scaleSigned(int32_t x, uint32_t num, uint32_t den)
+{
+  int32_t scaled = (int32_t)_scale(x < 0 ? -(uint32_t)x : (uint32_t)x, num, den);
+  return x < 0 ? -scaled : scaled;
+}
+
+SGP30AlertsBase::SGP30AlertsBase(SGP30Rule *rules, uint8_t capacity)
+{
+  _rules = rules;
+  _capacity = capacity;
+  _count = 0;
+}
+
+uint8_t SGP30AlertsBase::addAbove(SGP30SIGNAL signal, uint16_t set, uint16_t clear, SGP30AlertCallback callback, void *context)
+{
+  return _add(signal, 0, set, clear, 0, callback, context);
+}
+
+uint8_t SGP30AlertsBase::addBelow(SGP30SIGNAL signal, uint16_t set, uint16_t clear, SGP30AlertCallback callback, void *context)
+{
+  return _add(signal, SGP30_RULE_NEGATE, -(int32_t)set, -(int32_t)clear, 0, callback, context);
+}
+
+uint8_t SGP30AlertsBase::addRising(SGP30SIGNAL signal, uint16_t set, uint16_t clear, unsigned long window,
+                                   SGP30AlertCallback callback, void *context)
+{
+  return _add(signal, SGP30_RULE_SLOPE, set, clear, window, callback, context);
+}
+
+uint8_t SGP30AlertsBase::addFalling(SGP30SIGNAL signal, uint16_t set, uint16_t clear, unsigned long window,
+                                    SGP30AlertCallback callback, void *context)
+{
+  return _add(signal, SGP30_RULE_SLOPE | SGP30_RULE_NEGATE, set, clear, window, callback, context);
+}
+
+uint8_t SGP30AlertsBase::_add(uint8_t signal, uint8_t flags, int32_t set, int32_t clear, unsigned long window,
+                              SGP30AlertCallback callback, void *context)
+{
+  if (_count >= _capacity || _count == SGP30_NO_RULE)
+    return SGP30_NO_RULE;
+  SGP30Rule &rule = _rules[_count];
+  rule.callback = callback;
+  rule.context = context;
+  rule.window = window > 0 ? window : 1;
+  rule.set = set;
+  rule.clear = clear;
+  if (flags & SGP30_RULE_SLOPE)
+  {
+    //Units per minute to the change over one window, compared as is on every reading
+    rule.set = _scaleSigned(set * 256, rule.window, 60000);
+    rule.clear = _scaleSigned(clear * 256, rule.window, 60000);
+  }
+  rule.last = 0;
+  rule.change = 0;
+  rule.previous = 0;
+  rule.signal = signal;
+  rule.flags = flags;
+  rule.debounce = 1;
+  rule.pending = 0;
+  return _count++;
+}
+
+//Readings in a row that must agree before a rule changes state
+void SGP30AlertsBase::setDebounce(uint8_t rule, uint8_t readings)
+{
+  if (rule < _count)
+    _rules[rule].debounce = readings > 0 ? readings : 1;
+}
+
+//Evaluates every rule for the signals the sample carries
+void SGP30AlertsBase::update(const SGP30Sample &sample, uint8_t sources)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    SGP30Rule &rule = _rules[i];
+    uint16_t value;
+    switch (rule.signal)
+    {
+    case SGP30_SIGNAL_CO2:
+      value = sample.CO2;
+      break;
+    case SGP30_SIGNAL_TVOC:
+      value = sample.TVOC;
+      break;
+    case SGP30_SIGNAL_H2:
+      value = sample.H2;
+      break;
+    default:
+      value = sample.ethanol;
+      break;
+    }
+    uint8_t source = rule.signal <= SGP30_SIGNAL_TVOC ? SGP30_HISTORY_AIR_QUALITY : SGP30_HISTORY_RAW_SIGNALS;
+    if (sources & source)
+      _evaluate(rule, i, value, sample);
+  }
+}
+
+//One reading of the rule's signal
+void SGP30AlertsBase::_evaluate(SGP30Rule &rule, uint8_t index, uint16_t value, const SGP30Sample &sample)
+{
+  int32_t x = value;
+  if (rule.flags & SGP30_RULE_SLOPE)
+  {
+    uint32_t elapsed = (uint32_t)(sample.timestamp - rule.last);
+    if (!(rule.flags & SGP30_RULE_PRIMED) || elapsed == 0)
+    {
+      rule.flags |= SGP30_RULE_PRIMED; //no slope from a single reading
+      rule.previous = value;
+      rule.last = sample.timestamp;
+      return;
+    }
+    //Rate since the previous reading, weighed by the share of the window it covers:
+    //slope += (rate - slope) * elapsed / window, rate = delta / elapsed
+    //Kept as the change over one window, slope * window, that is
+    //change += delta - change * elapsed / window
+    int32_t delta = ((int32_t)value - rule.previous) * 256;
+    int32_t change;
+    if (elapsed >= rule.window)
+      change = _scaleSigned(delta, rule.window, elapsed); //a gap of a whole window, start over
+    else
+      change = rule.change - _scaleSigned(rule.change, elapsed, rule.window) + delta;
+    if (change > SGP30_CHANGE_LIMIT)
+      change = SGP30_CHANGE_LIMIT;
+    else if (change < -SGP30_CHANGE_LIMIT)
+      change = -SGP30_CHANGE_LIMIT;
+    rule.change = change;
+    rule.previous = value;
+    rule.last = sample.timestamp;
+    x = change;
+  }
+  if (rule.flags & SGP30_RULE_NEGATE)
+    x = -x;
+
+  bool active = rule.flags & SGP30_RULE_ACTIVE;
+  if (active ? x >= rule.clear : x < rule.set)
+  {
+    rule.pending = 0; //agrees with the state
+    return;
+  }
+  if (++rule.pending < rule.debounce)
+    return;
+  rule.pending = 0;
+  rule.flags ^= SGP30_RULE_ACTIVE;
+  if (rule.callback != NULL)
+    rule.callback(index, !active, sample, rule.context);
+}
+
+//State of a rule, false for an unknown rule
+bool SGP30AlertsBase::active(uint8_t rule)
+{
+  return rule < _count && (_rules[rule].flags & SGP30_RULE_ACTIVE);
+}
+
+//Averaged slope of a rising / falling rule, units per minute
+int16_t SGP30AlertsBase::slope(uint8_t rule)
+{
+  if (rule >= _count)
+    return 0;
+  int32_t slope = _scaleSigned(_rules[rule].change, 60000, _rules[rule].window) / 256;
+  if (slope > 32767)
+    return 32767;
+  if (slope < -32767)
+    return -32767;
+  return (int16_t)slope;
+}
+
+//Turns every rule off and forgets their readings
+void SGP30AlertsBase::reset(void)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _rules[i].flags &= ~(SGP30_RULE_ACTIVE | SGP30_RULE_PRIMED);
+    _rules[i].change = 0;
+    _rules[i].pending = 0;
+  }
+}
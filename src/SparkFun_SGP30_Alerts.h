@@ -0,0 +1,119 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Alert rules evaluated on every reading.
+  SGP30Alerts<Rules> holds up to Rules rules without using the heap. Once
+  attached with SGP30::attachAlerts() it sees each successful measurement,
+  or samples can be fed with update(). Each rule is on or off:
+    above / below    the value reaches set, and goes back past clear
+    rising / falling the slope reaches set (units per minute), and goes
+                     back past clear
+  set and clear apart give hysteresis, setDebounce() asks for a number of
+  readings in a row before the state changes. The slope is the change per
+  minute averaged over the rule's window, with older readings weighing
+  exponentially less, so every rule costs the same small constant time per
+  reading whatever the window, in 32 bit arithmetic only. A rule only
+  looks at readings of its signal: air quality measurements for CO2 /
+  TVOC, raw signals for H2 / ethanol.
+  The callback given with a rule is called when its state changes, from
+  inside the measurement, so keep it short.
+*/
+
+#ifndef SparkFun_SGP30_Alerts_h
+#define SparkFun_SGP30_Alerts_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_History.h"
+
+//Returned when there is no room for another rule
+#define SGP30_NO_RULE 0xFF
+
+//Called with the rule's index and new state, and the reading that changed it
+typedef void (*SGP30AlertCallback)(uint8_t rule, bool active, const SGP30Sample &sample, void *context);
+
+struct SGP30Rule
+{
+  SGP30AlertCallback callback;
+  void *context;
+  int32_t set;           //on at or above, below / falling compare negated values
+  int32_t clear;         //off under it, slopes in the same units as change
+  unsigned long window;  //ms, 0 for a threshold
+  unsigned long last;    //timestamp of the previous reading
+  int32_t change;        //slope as the change over one window, 8 fractional bits
+  uint16_t previous;     //previous value, for the slope
+  uint8_t signal;        //SGP30SIGNAL
+  uint8_t flags;         //see SparkFun_SGP30_Alerts.cpp
+  uint8_t debounce;      //readings in a row needed to change state
+  uint8_t pending;       //readings in a row that disagree with the state
+};
+
+class SGP30AlertsBase : public SGP30Observer
+{
+public:
+  //Rules on the value of a signal
+  //above: on once value >= set, off again once value < clear (clear <= set)
+  //below: on once value <= set, off again once value > clear (clear >= set)
+  //Return the rule's index, or SGP30_NO_RULE if full
+  uint8_t addAbove(SGP30SIGNAL signal, uint16_t set, uint16_t clear, SGP30AlertCallback callback = NULL, void *context = NULL);
+  uint8_t addBelow(SGP30SIGNAL signal, uint16_t set, uint16_t clear, SGP30AlertCallback callback = NULL, void *context = NULL);
+
+  //Rules on the slope of a signal in units per minute, averaged over window ms
+  //rising: on once slope >= set, off again once slope < clear (clear <= set)
+  //falling: on once slope <= -set, off again once slope > -clear
+  uint8_t addRising(SGP30SIGNAL signal, uint16_t set, uint16_t clear, unsigned long window,
+                    SGP30AlertCallback callback = NULL, void *context = NULL);
+  uint8_t addFalling(SGP30SIGNAL signal, uint16_t set, uint16_t clear, unsigned long window,
+                     SGP30AlertCallback callback = NULL, void *context = NULL);
+
+  //Readings in a row that must agree before a rule changes state, default 1
+  void setDebounce(uint8_t rule, uint8_t readings);
+
+  //Evaluates every rule for the signals the sample carries, in order
+  //sources is SGP30_HISTORY_AIR_QUALITY (CO2 and TVOC) and/or SGP30_HISTORY_RAW_SIGNALS (H2 and ethanol)
+  //Samples must be given in timestamp order
+  void update(const SGP30Sample &sample, uint8_t sources = SGP30_HISTORY_AIR_QUALITY | SGP30_HISTORY_RAW_SIGNALS);
+
+  //Called by SGP30 with each measurement
+  void onSample(SGP30 &, const SGP30Sample &sample, uint8_t source) { update(sample, source); }
+
+  //State of a rule, false for an unknown rule
+  bool active(uint8_t rule);
+
+  //Averaged slope of a rising / falling rule, units per minute
+  int16_t slope(uint8_t rule);
+
+  //Turns every rule off and forgets their readings, without callbacks
+  void reset(void);
+
+  //Removes every rule
+  void clear(void) { _count = 0; }
+
+  //Number of rules and the most that fit
+  uint8_t size(void) { return _count; }
+  uint8_t capacity(void) { return _capacity; }
+
+protected:
+  SGP30AlertsBase(SGP30Rule *rules, uint8_t capacity);
+
+private:
+  SGP30Rule *_rules;
+  uint8_t _capacity;
+  uint8_t _count;
+
+  uint8_t _add(uint8_t signal, uint8_t flags, int32_t set, int32_t clear, unsigned long window,
+               SGP30AlertCallback callback, void *context);
+  void _evaluate(SGP30Rule &rule, uint8_t index, uint16_t value, const SGP30Sample &sample);
+};
+
+template <uint8_t Rules>
+class SGP30Alerts : public SGP30AlertsBase
+{
+public:
+  SGP30Alerts() : SGP30AlertsBase(_storage, Rules) {}
+
+private:
+  SGP30Rule _storage[Rules];
+};
+
+#endif
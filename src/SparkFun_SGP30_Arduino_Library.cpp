@@ -37,299 +37,397 @@
 */
 
 #include "SparkFun_SGP30_Arduino_Library.h"
+#include "SparkFun_SGP30_Recovery.h"
+
+//Capabilities and the first feature set (product version) that has them
+//Feature set versions of the SGP30 are product type 0 in the top nibble
+static const struct
+{
+  uint8_t capability;
+  uint8_t version;
+} _capabilityTable[] = {
+    {SGP30_CAP_TVOC_INCEPTIVE_BASELINE, 0x21},
+    {SGP30_CAP_SET_TVOC_BASELINE, 0x21}};
 
 //Constructor
 SGP30::SGP30()
 {
-  CO2 = 0;
-  TVOC = 0;
-  baselineCO2 = 0;
-  baselineTVOC = 0;
-  featureSetVersion = 0;
-  H2 = 0;
-  ethanol = 0;
-  serialID = 0;
+  inceptiveBaselineTVOC = 0;
+  _observers = NULL;
+  _recorder = NULL;
+  _fastStartup = false;
+  _knownBaselineCO2 = 0;
+  _knownBaselineTVOC = 0;
+  _baselineKnown = false;
 }
 
 //Start I2C communication using specified port
 //Returns true if successful or false if no sensor detected
 bool SGP30::begin(TwoWire &wirePort)
 {
-  _i2cPort = &wirePort; //Grab which port the user wants us to use
+  _wire.setPort(wirePort); //Grab which port the user wants us to use
+  return begin(_wire);
+}
+
+//Start communication over any transport
+//Returns true if successful or false if no sensor detected
+bool SGP30::begin(SGP30Transport &transport)
+{
+  _transport = &transport;
+  if (_recorder != NULL && &transport != _recorder)
+  {
+    _recorder->setTransport(transport); //keep recording, reinitialize() passes the recorder itself
+    _transport = _recorder;
+  }
+  _pendingCommand = NULL;
+  serialID = 0; //not left over from a previous sensor if this one doesn't answer
+  featureSetVersion = 0;
   getSerialID();
   if (serialID == 0)
     return false;
+  getFeatureSetVersion(); //tells the capabilities, none if it fails
   return true;
 }
 
 //Initilizes sensor for air quality readings
 //measureAirQuality should be called in 1 second intervals after this function
-void SGP30::initAirQuality(void)
+//Returns SGP30_ERR_I2C_TIMEOUT if the sensor did not acknowledge the command
+SGP30ERR SGP30::initAirQuality(void)
+{
+  SGP30ERR error = Basic::initAirQuality();
+  if (error != SGP30_SUCCESS)
+    return error;
+  for (SGP30Observer *observer = _observers; observer != NULL; observer = observer->_next)
+    observer->onInit(*this); //restores a stored baseline, starts the warm-up...
+  //Asked for and nothing to restore: the inceptive baseline gets TVOC going
+  //much sooner than the sensor's own calibration would
+  if (_fastStartup && !_baselineKnown &&
+      supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE | SGP30_CAP_SET_TVOC_BASELINE))
+  {
+    delay(10); //init_air_quality takes up to 10ms
+    error = getTVOCInceptiveBaseline();
+    if (error == SGP30_SUCCESS)
+      error = setTVOCBaseline(inceptiveBaselineTVOC);
+  }
+  return error;
+}
+
+//Whether initAirQuality() uses the TVOC inceptive baseline
+void SGP30::setFastStartup(bool enable)
+{
+  _fastStartup = enable;
+}
+
+//True if the chip supports every capability given
+bool SGP30::supports(uint8_t capabilities)
+{
+  uint8_t supported = 0;
+  if ((featureSetVersion & 0xF000) == 0) //product type SGP30
+  {
+    for (uint8_t i = 0; i < sizeof(_capabilityTable) / sizeof(_capabilityTable[0]); i++)
+      if ((uint8_t)featureSetVersion >= _capabilityTable[i].version)
+        supported |= _capabilityTable[i].capability;
+  }
+  return (supported & capabilities) == capabilities;
+}
+
+//Reads the TVOC inceptive baseline into inceptiveBaselineTVOC
+//datasheet says 10ms
+SGP30ERR SGP30::getTVOCInceptiveBaseline(void)
+{
+  if (!supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE))
+    return SGP30_ERR_UNSUPPORTED; //older chips don't know the command
+  uint16_t words[1];
+  SGP30ERR error = _measure(get_tvoc_inceptive_baseline, 10, words, 1);
+  if (error == SGP30_SUCCESS)
+    inceptiveBaselineTVOC = words[0]; //publish valid data
+  return error;
+}
+
+SGP30ERR SGP30::startTVOCInceptiveBaseline(void)
 {
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(init_air_quality, 2); //command to initialize air quality readings
-  _i2cPort->endTransmission();
+  if (!supports(SGP30_CAP_TVOC_INCEPTIVE_BASELINE))
+    return SGP30_ERR_UNSUPPORTED;
+  return _startCommand(get_tvoc_inceptive_baseline, 10);
 }
 
-//Measure air quality
-//Call in regular intervals of 1 second to maintain synamic baseline calculations
-//CO2 returned in ppm, Total Volatile Organic Compounds (TVOC) returned in ppb
-//Will give fixed values of CO2=400 and TVOC=0 for first 15 seconds after init
+SGP30ERR SGP30::readTVOCInceptiveBaseline(void)
+{
+  uint16_t words[1];
+  SGP30ERR error = _read(get_tvoc_inceptive_baseline, words, 1);
+  if (error == SGP30_SUCCESS)
+    inceptiveBaselineTVOC = words[0]; //publish valid data
+  return error;
+}
+
+//Sets the TVOC baseline alone
+SGP30ERR SGP30::setTVOCBaseline(uint16_t baselineTVOC)
+{
+  if (!supports(SGP30_CAP_SET_TVOC_BASELINE))
+    return SGP30_ERR_UNSUPPORTED;
+  if (_pendingCommand != NULL)
+    return SGP30_ERR_BUSY; //would drop the unread result
+  const uint16_t words[1] = {baselineTVOC};
+  if (!_writeWords(set_tvoc_baseline, words))
+    return SGP30_ERR_I2C_TIMEOUT;
+  return SGP30_SUCCESS;
+}
+
+//Measure air quality, with retries if a recovery is attached
 //Returns SGP30_SUCCESS if successful or other error code if unsuccessful
 SGP30ERR SGP30::measureAirQuality(void)
 {
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(measure_air_quality, 2); //command to measure air quality
-  _i2cPort->endTransmission();
-  //Hang out while measurement is taken. datasheet says 10-12ms
-  delay(12);
-  //Comes back in 6 bytes, CO2 data(MSB) / data(LSB) / Checksum / TVOC data(MSB) / data(LSB) / Checksum
-  uint8_t toRead;
-  toRead = _i2cPort->requestFrom(_SGP30Address, (uint8_t)6);
-  if (toRead != 6)
-    return SGP30_ERR_I2C_TIMEOUT;              //Error out
-  uint16_t _CO2 = _i2cPort->read() << 8; //store MSB in CO2
-  _CO2 |= _i2cPort->read();              //store LSB in CO2
-  uint8_t checkSum = _i2cPort->read();   //verify checksum
-  if (checkSum != _CRC8(_CO2))
-    return SGP30_ERR_BAD_CRC;                   //checksum failed
-  uint16_t _TVOC = _i2cPort->read() << 8; //store MSB in TVOC
-  _TVOC |= _i2cPort->read();              //store LSB in TVOC
-  checkSum = _i2cPort->read();            //verify checksum
-  if (checkSum != _CRC8(_TVOC))
-    return SGP30_ERR_BAD_CRC; //checksum failed
-  CO2 = _CO2;           //publish valid data
-  TVOC = _TVOC;         //publish valid data
+  SGP30ERR error;
+  for (SGP30Observer *observer = _observers; observer != NULL; observer = observer->_next)
+    if (observer->measure(*this, error))
+      return error; //start and read below, with retries
+  uint16_t lastCO2 = CO2, lastTVOC = TVOC;
+  return _airQuality(Basic::measureAirQuality(), lastCO2, lastTVOC);
+}
+
+//A command the sensor did not take is a failed reading as far as recovery goes
+SGP30ERR SGP30::startAirQuality(void)
+{
+  SGP30ERR error = Basic::startAirQuality();
+  if (error == SGP30_ERR_I2C_TIMEOUT)
+    _airQuality(error, CO2, TVOC);
+  return error;
+}
+
+SGP30ERR SGP30::readAirQuality(void)
+{
+  uint16_t lastCO2 = CO2, lastTVOC = TVOC;
+  SGP30ERR error = Basic::readAirQuality();
+  if (error == SGP30_ERR_NOT_READY)
+    return error; //nothing was read
+  return _airQuality(error, lastCO2, lastTVOC);
+}
+
+//Outcome of an air quality reading: recovery, then everything fed by the new values
+SGP30ERR SGP30::_airQuality(SGP30ERR error, uint16_t lastCO2, uint16_t lastTVOC)
+{
+  bool publish = true;
+  for (SGP30Observer *observer = _observers; observer != NULL; observer = observer->_next)
+    if (!observer->onAirQuality(*this, error))
+      publish = false;
+  if (error != SGP30_SUCCESS)
+    return error;
+  if (!publish)
+  {
+    CO2 = lastCO2; //warm-up after a recovery, last real values are kept
+    TVOC = lastTVOC;
+    return SGP30_ERR_NOT_READY; //read fine, but nothing new
+  }
+  _publish();
+  _notify(SGP30_HISTORY_AIR_QUALITY);
   return SGP30_SUCCESS;
 }
 
-//Returns the current calculated baseline from
-//the sensor's dynamic baseline calculations
-//Save baseline periodically to non volatile memory
-//(like EEPROM) to restore after new power up or
-//after soft reset using setBaseline();
-//Returns SGP30_SUCCESS if successful or other error code if unsuccessful
 SGP30ERR SGP30::getBaseline(void)
 {
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(get_baseline, 2);
-  _i2cPort->endTransmission();
-  //Hang out while measurement is taken. datasheet says 10ms
-  delay(10);
-  uint8_t toRead;
-  //Comes back in 6 bytes, baselineCO2 data(MSB) / data(LSB) / Checksum / baselineTVOC data(MSB) / data(LSB) / Checksum
-  toRead = _i2cPort->requestFrom(_SGP30Address, (uint8_t)6);
-  if (toRead != 6)
-    return SGP30_ERR_I2C_TIMEOUT;                      //Error out
-  uint16_t _baselineCO2 = _i2cPort->read() << 8; //store MSB in _baselineCO2
-  _baselineCO2 |= _i2cPort->read();              //store LSB in _baselineCO2
-  uint8_t checkSum = _i2cPort->read();           //verify checksum
-  if (checkSum != _CRC8(_baselineCO2))
-    return SGP30_ERR_BAD_CRC;                           //checksum failed
-  uint16_t _baselineTVOC = _i2cPort->read() << 8; //store MSB in _baselineTVOC
-  _baselineTVOC |= _i2cPort->read();              //store LSB in _baselineTVOC
-  checkSum = _i2cPort->read();                    //verify checksum
-  if (checkSum != _CRC8(_baselineTVOC))
-    return SGP30_ERR_BAD_CRC;         //checksum failed
-  baselineCO2 = _baselineCO2;   //publish valid data
-  baselineTVOC = _baselineTVOC; //publish valid data
+  return _baseline(Basic::getBaseline());
+}
+
+SGP30ERR SGP30::readBaseline(void)
+{
+  return _baseline(Basic::readBaseline());
+}
+
+SGP30ERR SGP30::_baseline(SGP30ERR error)
+{
+  if (error != SGP30_SUCCESS)
+    return error;
+  //Not published here: the snapshot's timestamp is the measurement's, the
+  //baseline goes out with the next one
+  _knownBaselineCO2 = baselineCO2;
+  _knownBaselineTVOC = baselineTVOC;
+  _baselineKnown = true;
   return SGP30_SUCCESS;
 }
 
 //Updates the baseline to a previous baseline
 //Should only use with previously retrieved baselines
 //to maintain accuracy
-void SGP30::setBaseline(uint16_t baselineCO2, uint16_t baselineTVOC)
-{
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(set_baseline, 2);     //command to set baseline
-  _i2cPort->write(baselineTVOC >> 8);   //write baseline TVOC MSB
-  _i2cPort->write(baselineTVOC);        //write baseline TVOC LSB
-  _i2cPort->write(_CRC8(baselineTVOC)); //write checksum TVOC baseline
-  _i2cPort->write(baselineCO2 >> 8);    //write baseline CO2 MSB
-  _i2cPort->write(baselineCO2);         //write baseline CO2 LSB
-  _i2cPort->write(_CRC8(baselineCO2));  //write checksum CO2 baseline
-  _i2cPort->endTransmission();
-}
-
-//Set humidity
-//humidity value is a fixed point 8.8 bit number
-//Value should be absolute humidity from humidity sensor
-//default value 0x0F80 = 15.5g/m^3
-//minimum value 0x0001 = 1/256g/m^3
-//maximum value 0xFFFF = 255+255/256 g/m^3
-//sending 0x0000 resets to default and turns off humidity compensation
-void SGP30::setHumidity(uint16_t humidity)
-{
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(set_humidity, 2); //command to set humidity
-  _i2cPort->write(humidity >> 8);   //write humidity MSB
-  _i2cPort->write(humidity);        //write humidity LSB
-  _i2cPort->write(_CRC8(humidity)); //write humidity checksum
-  _i2cPort->endTransmission();
-}
-
-//gives feature set version number (see data sheet)
-//Returns SGP30_SUCCESS if successful or other error code if unsuccessful
-SGP30ERR SGP30::getFeatureSetVersion(void)
-{
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(get_feature_set_version, 2); //command to get feature version
-  _i2cPort->endTransmission();
-  //Hang out while measurement is taken. datasheet says 1-2ms
-  delay(2);
-  uint8_t toRead;
-  //Comes back in 3 bytes, data(MSB) / data(LSB) / Checksum
-  toRead = _i2cPort->requestFrom(_SGP30Address, (uint8_t)3);
-  if (toRead != 3)
-    return SGP30_ERR_I2C_TIMEOUT;                            //Error out
-  uint16_t _featureSetVersion = _i2cPort->read() << 8; //store MSB in featureSetVerison
-  _featureSetVersion |= _i2cPort->read();              //store LSB in featureSetVersion
-  uint8_t checkSum = _i2cPort->read();                 //verify checksum
-  if (checkSum != _CRC8(_featureSetVersion))
-    return SGP30_ERR_BAD_CRC;                   //checksum failed
-  featureSetVersion = _featureSetVersion; //publish valid data
+SGP30ERR SGP30::setBaseline(uint16_t baselineCO2, uint16_t baselineTVOC)
+{
+  SGP30ERR error = Basic::setBaseline(baselineCO2, baselineTVOC);
+  if (error != SGP30_SUCCESS)
+    return error;
+  _knownBaselineCO2 = baselineCO2;
+  _knownBaselineTVOC = baselineTVOC;
+  _baselineKnown = true;
   return SGP30_SUCCESS;
 }
 
-//Intended for part verification and testing
-//these raw signals are used as inputs to the onchip calibrations and algorithms
-//Returns SUCCESS if successful or other error code if unsuccessful
 SGP30ERR SGP30::measureRawSignals(void)
 {
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(measure_raw_signals, 2); //command to measure raw signals
-  _i2cPort->endTransmission();
-  //Hang out while measurement is taken. datasheet says 20-25ms
-  delay(25);
-  uint8_t toRead;
-  //Comes back in 6 bytes, H2 data(MSB) / data(LSB) / Checksum / ethanol data(MSB) / data(LSB) / Checksum
-  toRead = _i2cPort->requestFrom(_SGP30Address, (uint8_t)6);
-  if (toRead != 6)
-    return SGP30_ERR_I2C_TIMEOUT;             //Error out
-  uint16_t _H2 = _i2cPort->read() << 8; //store MSB in _H2
-  _H2 |= _i2cPort->read();              //store LSB in _H2
-  uint8_t checkSum = _i2cPort->read();  //verify checksum
-  if (checkSum != _CRC8(_H2))
-    return SGP30_ERR_BAD_CRC;                      //checksumfailed
-  uint16_t _ethanol = _i2cPort->read() << 8; //store MSB in ethanol
-  _ethanol |= _i2cPort->read();              //store LSB in ethanol
-  checkSum = _i2cPort->read();               //verify checksum
-  if (checkSum != _CRC8(_ethanol))
-    return SGP30_ERR_BAD_CRC; //checksum failed
-  H2 = _H2;             //publish valid data
-  ethanol = _ethanol;   //publish valid data
-  return SGP30_SUCCESS;
+  return _rawSignals(Basic::measureRawSignals());
 }
 
-//Soft reset - not device specific
-//will reset all devices that support general call mode
-void SGP30::generalCallReset(void)
+SGP30ERR SGP30::readRawSignals(void)
 {
-  _i2cPort->beginTransmission(0x00); //general call address
-  _i2cPort->write(0x06);             //reset command
-  _i2cPort->endTransmission();
+  return _rawSignals(Basic::readRawSignals());
 }
 
-//readout of serial ID register can identify chip and verify sensor presence
-//Returns SGP30_SUCCESS if successful or other error code if unsuccessful
-SGP30ERR SGP30::getSerialID(void)
-{
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(get_serial_id, 2); //command to get serial ID
-  _i2cPort->endTransmission();
-  //Hang out while measurement is taken.
-  delay(1);
-  uint8_t toRead;
-  //Comes back in 9 bytes, H2 data(MSB) / data(LSB) / Checksum / ethanol data(MSB) / data(LSB) / Checksum
-  toRead = _i2cPort->requestFrom(_SGP30Address, (uint8_t)9);
-  if (toRead != 9)
-    return SGP30_ERR_I2C_TIMEOUT;                    //Error out
-  uint16_t _serialID1 = _i2cPort->read() << 8; //store MSB to top of _serialID1
-  _serialID1 |= _i2cPort->read();              //store next byte in _serialID1
-  uint8_t checkSum1 = _i2cPort->read();        //verify checksum
-  if (checkSum1 != _CRC8(_serialID1))
-    return SGP30_ERR_BAD_CRC;                        //checksum failed
-  uint16_t _serialID2 = _i2cPort->read() << 8; //store next byte to top of _serialID2
-  _serialID2 |= _i2cPort->read();              //store next byte in _serialID2
-  uint8_t checkSum2 = _i2cPort->read();        //verify checksum
-  if (checkSum2 != _CRC8(_serialID2))
-    return SGP30_ERR_BAD_CRC;                        //checksum failed
-  uint16_t _serialID3 = _i2cPort->read() << 8; //store next byte to top of _serialID3
-  _serialID3 |= _i2cPort->read();              //store LSB in _serialID3
-  uint8_t checkSum3 = _i2cPort->read();        //verify checksum
-  if (checkSum3 != _CRC8(_serialID3))
-    return SGP30_ERR_BAD_CRC;                                                                            //checksum failed
-  serialID = ((uint64_t)_serialID1 << 32) + ((uint64_t)_serialID2 << 16) + ((uint64_t)_serialID3); //publish valid data
+SGP30ERR SGP30::_rawSignals(SGP30ERR error)
+{
+  if (error != SGP30_SUCCESS)
+    return error;
+  _publish();
+  _notify(SGP30_HISTORY_RAW_SIGNALS);
   return SGP30_SUCCESS;
 }
 
-//Sensor runs on chip self test
-//Returns SGP30_SUCCESS if successful or other error code if unsuccessful
-SGP30ERR SGP30::measureTest(void)
-{
-  _i2cPort->beginTransmission(_SGP30Address);
-  _i2cPort->write(measure_test, 2); //command to get self test
-  _i2cPort->endTransmission();
-  //Hang out while measurement is taken. datasheet says 200-220ms
-  delay(220);
-  uint8_t toRead;
-  //Comes back in 3 bytes, data(MSB) / data(LSB) / Checksum
-  toRead = _i2cPort->requestFrom(_SGP30Address, (uint8_t)3);
-  if (toRead != 3)
-    return SGP30_ERR_I2C_TIMEOUT;                 //Error out
-  uint16_t results = _i2cPort->read() << 8; //store MSB in results
-  results |= _i2cPort->read();              //store LSB in results
-  uint8_t checkSum = _i2cPort->read();      //verify checksum
-  if (checkSum != _CRC8(results))
-    return SGP30_ERR_BAD_CRC; //checksum failed
-  if (results != 0xD400)
-    return SGP30_SELF_TEST_FAIL; //self test results incorrect
-  return SGP30_SUCCESS;
+//Consistent copy of every result, safe from other tasks, threads and ISRs
+bool SGP30::tryReadSnapshot(SGP30Snapshot &snapshot) const
+{
+  return _snapshot.tryRead(snapshot);
+}
+
+void SGP30::readSnapshot(SGP30Snapshot &snapshot) const
+{
+  _snapshot.read(snapshot);
+}
+
+//Records every successful measurement in history
+void SGP30::attachHistory(SGP30HistoryBase &history, uint8_t sources)
+{
+  history.setSources(sources);
+  _attach(history);
 }
 
-#ifndef SGP30_LOOKUP_TABLE
-//Given an array and a number of bytes, this calculate CRC8 for those bytes
-//CRC is only calc'd on the data portion (two bytes) of the four bytes being sent
-//From: http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
-//Tested with: http://www.sunshine2k.de/coding/javascript/crc/crc_js.html
-//x^8+x^5+x^4+1 = 0x31
-uint8_t SGP30::_CRC8(uint16_t data)
+void SGP30::detachHistory(SGP30HistoryBase &history)
 {
-  uint8_t crc = 0xFF; //Init with 0xFF
+  _detach(history);
+}
 
-  crc ^= (data >> 8); // XOR-in the first input byte
+//Evaluates alert rules on every successful measurement
+void SGP30::attachAlerts(SGP30AlertsBase &alerts)
+{
+  _attach(alerts);
+}
+
+void SGP30::detachAlerts(SGP30AlertsBase &alerts)
+{
+  _detach(alerts);
+}
+
+//Saves the baseline on a schedule and restores it on initAirQuality()
+void SGP30::attachBaselineManager(SGP30BaselineManager &manager)
+{
+  _attach(manager);
+}
+
+void SGP30::detachBaselineManager(SGP30BaselineManager &manager)
+{
+  _detach(manager);
+}
 
-  for (uint8_t i = 0; i < 8; i++)
+//Retries failed measurements and re-initializes the sensor when they keep failing
+void SGP30::attachRecovery(SGP30Recovery &recovery)
+{
+  _attach(recovery);
+}
+
+void SGP30::detachRecovery(SGP30Recovery &recovery)
+{
+  _detach(recovery);
+}
+
+//Adds an observer after the others, once
+void SGP30::_attach(SGP30Observer &observer)
+{
+  _detach(observer);
+  SGP30Observer **last = &_observers;
+  while (*last != NULL)
+    last = &(*last)->_next;
+  *last = &observer;
+}
+
+void SGP30::_detach(SGP30Observer &observer)
+{
+  for (SGP30Observer **link = &_observers; *link != NULL; link = &(*link)->_next)
   {
-    if ((crc & 0x80) != 0)
-      crc = (uint8_t)((crc << 1) ^ 0x31);
-    else
-      crc <<= 1;
+    if (*link == &observer)
+    {
+      *link = observer._next;
+      observer._next = NULL;
+      return;
+    }
   }
-  crc ^= (uint8_t)data; // XOR-in the last input byte
+}
 
-  for (uint8_t i = 0; i < 8; i++)
+//Records every bus transaction from now on
+void SGP30::attachRecorder(SGP30TraceRecorder &recorder)
+{
+  detachRecorder();
+  recorder.setTransport(*_transport);
+  _transport = &recorder;
+  _recorder = &recorder;
+}
+
+void SGP30::detachRecorder(void)
+{
+  if (_recorder == NULL)
+    return;
+  _transport = _recorder->transport();
+  _recorder = NULL;
+}
+
+//Resets the sensor and restores air quality mode, baseline and humidity compensation
+bool SGP30::reinitialize(void)
+{
+  //generalCallReset() forgets the humidity, keep it
+  bool humiditySet = _humiditySet;
+  uint16_t humidity = _humidity;
+  generalCallReset();
+  delay(1); //soft reset takes 0.6ms
+  if (!begin(*_transport))
+    return false;
+  if (initAirQuality() != SGP30_SUCCESS)
+    return false;
+  delay(10); //init_air_quality takes up to 10ms
+  if (_baselineKnown)
+  {
+    if (setBaseline(_knownBaselineCO2, _knownBaselineTVOC) != SGP30_SUCCESS)
+      return false;
+    delay(10);
+  }
+  if (humiditySet)
   {
-    if ((crc & 0x80) != 0)
-      crc = (uint8_t)((crc << 1) ^ 0x31);
-    else
-      crc <<= 1;
+    if (setHumidity(humidity) != SGP30_SUCCESS)
+      return false; //not remembered either, setRelativeHumidity() sends it again
+    delay(10);
   }
+  return true;
+}
 
-  return crc; //No output reflection
+//Hands the published values to the observers, stamped with the time the measurement was started
+void SGP30::_notify(uint8_t source)
+{
+  if (_observers == NULL)
+    return;
+  SGP30Sample sample;
+  sample.timestamp = _commandStart;
+  sample.CO2 = CO2;
+  sample.TVOC = TVOC;
+  sample.H2 = H2;
+  sample.ethanol = ethanol;
+  for (SGP30Observer *observer = _observers; observer != NULL; observer = observer->_next)
+    observer->onSample(*this, sample, source);
 }
-#endif
 
-#ifdef SGP30_LOOKUP_TABLE
-//Generates CRC8 for SGP30 from lookup table
-uint8_t SGP30::_CRC8(uint16_t data)
+//Publishes every result at once, stamped with the time the measurement was started
+void SGP30::_publish(void)
 {
-  uint8_t CRC = 0xFF;                          //inital value
-  CRC ^= (uint8_t)(data >> 8);                 //start with MSB
-  CRC = _CRC8LookupTable[CRC >> 4][CRC & 0xF]; //look up table [MSnibble][LSnibble]
-  CRC ^= (uint8_t)data;                        //use LSB
-  CRC = _CRC8LookupTable[CRC >> 4][CRC & 0xF]; //look up table [MSnibble][LSnibble]
-  return CRC;
+  SGP30Snapshot snapshot;
+  snapshot.sequence = 0; //counted by the cell
+  snapshot.timestamp = _commandStart;
+  snapshot.CO2 = CO2;
+  snapshot.TVOC = TVOC;
+  snapshot.baselineCO2 = baselineCO2;
+  snapshot.baselineTVOC = baselineTVOC;
+  snapshot.H2 = H2;
+  snapshot.ethanol = ethanol;
+  _snapshot.publish(snapshot);
 }
-#endif
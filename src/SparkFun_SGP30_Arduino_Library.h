@@ -41,125 +41,170 @@
 
 #include "Arduino.h"
 #include <Wire.h>
-typedef enum
-{
-  SGP30_SUCCESS = 0,
-  SGP30_ERR_BAD_CRC,
-  SGP30_ERR_I2C_TIMEOUT,
-  SGP30_SELF_TEST_FAIL
-} SGP30ERR;
-
-const uint8_t init_air_quality[2] = {0x20, 0x03};
-const uint8_t measure_air_quality[2] = {0x20, 0x08};
-const uint8_t get_baseline[2] = {0x20, 0x15};
-const uint8_t set_baseline[2] = {0x20, 0x1E};
-const uint8_t set_humidity[2] = {0x20, 0x61};
-const uint8_t measure_test[2] = {0x20, 0x32};
-const uint8_t get_feature_set_version[2] = {0x20, 0x2F};
-const uint8_t get_serial_id[2] = {0x36, 0x82};
-const uint8_t measure_raw_signals[2] = {0x20, 0x50};
-
-class SGP30
+#include "SparkFun_SGP30_Basic.h"
+#include "SparkFun_SGP30_Observer.h"
+#include "SparkFun_SGP30_History.h"
+#include "SparkFun_SGP30_Alerts.h"
+#include "SparkFun_SGP30_Trace.h"
+#include "SparkFun_SGP30_Baseline.h"
+#include "SparkFun_SGP30_Humidity.h"
+#include "SparkFun_SGP30_Snapshot.h"
+
+class SGP30Recovery;
+
+//Capabilities found by begin() from the feature set version, see supports()
+#define SGP30_CAP_TVOC_INCEPTIVE_BASELINE 0x01 //get_tvoc_inceptive_baseline, feature set 0x21 and later
+#define SGP30_CAP_SET_TVOC_BASELINE 0x02       //set_tvoc_baseline, feature set 0x21 and later
+
+//Every command and feature of the library: BasicSGP30 with all the features
+//(see SparkFun_SGP30_Basic.h) plus the hooks below
+class SGP30 : public BasicSGP30<SGP30_ALL_FEATURES>
 {
   // user-accessible "public" interface
 public:
-  uint16_t CO2;
-  uint16_t TVOC;
-  uint16_t baselineCO2;
-  uint16_t baselineTVOC;
-  uint16_t featureSetVersion;
-  uint16_t H2;
-  uint16_t ethanol;
-  uint64_t serialID;
+  //CO2, TVOC, baselineCO2, baselineTVOC, featureSetVersion, H2, ethanol and
+  //serialID come from the features
+  uint16_t inceptiveBaselineTVOC;
 
   //default constructor
   SGP30();
 
   //Start I2C communication using specified port
+  //Reads the serial ID, then the feature set version to find what the chip supports
   bool begin(TwoWire &wirePort = Wire); //If user doesn't specificy then Wire will be used
 
+  //Start communication over any transport (see SparkFun_SGP30_Transport.h)
+  //e.g. SGP30LinuxI2C on Linux or SGP30MemoryTransport in tests
+  bool begin(SGP30Transport &transport);
+
   //Initializes sensor for air quality readings
-  void initAirQuality(void);
+  //Restores a stored baseline if a baseline manager is attached
+  //Otherwise, with setFastStartup(true) on chips that support it, starts
+  //TVOC from the inceptive baseline so TVOC readings become useful sooner
+  //Returns SGP30_ERR_I2C_TIMEOUT, and does none of that, if the sensor did
+  //not acknowledge the command, or the error of the inceptive baseline
+  //commands (air quality mode is running regardless)
+  SGP30ERR initAirQuality(void);
+
+  //Whether initAirQuality() uses the TVOC inceptive baseline when there
+  //is no baseline to restore, default false: it adds two commands and
+  //about 20ms to every init
+  void setFastStartup(bool enable);
+
+  //True if the chip supports every capability given (SGP30_CAP_*)
+  //Known after begin(), from featureSetVersion
+  bool supports(uint8_t capabilities);
+
+  //Reads the TVOC inceptive baseline into inceptiveBaselineTVOC
+  //Only meaningful right after initAirQuality() on a sensor with no baseline
+  //returns SGP30_ERR_UNSUPPORTED on chips before feature set 0x21
+  SGP30ERR getTVOCInceptiveBaseline(void);
+  SGP30ERR startTVOCInceptiveBaseline(void);
+  SGP30ERR readTVOCInceptiveBaseline(void);
+
+  //Sets the TVOC baseline alone, e.g. to the inceptive baseline
+  //returns SGP30_ERR_UNSUPPORTED on chips before feature set 0x21
+  SGP30ERR setTVOCBaseline(uint16_t baselineTVOC);
 
   //Measure air quality
   //Call in regular intervals of 1 second to maintain synamic baseline calculations
+  //(SGP30Scheduler in SparkFun_SGP30_Scheduler.h keeps that cadence without drift)
   //CO2 returned in ppm, Total Volatile Organic Compounds (TVOC) returned in ppb
   //Will give fixed values of CO2=400 and TVOC=0 for first 15 seconds after init
-  //returns false if CRC8 check failed and true if successful
+  //Goes through the recovery, then feeds the snapshot, history, alerts and
+  //baseline manager
+  //Returns SGP30_ERR_NOT_READY while the recovery holds the last values
   SGP30ERR measureAirQuality(void);
+  SGP30ERR startAirQuality(void);
+  SGP30ERR readAirQuality(void);
 
-  //Returns the current calculated baseline from
-  //the sensor's dynamic baseline calculations
-  //Save baseline periodically to non volatile memory
-  //(like EEPROM) to restore after new power up or
-  //after soft reset using setBaseline();
-  //returns false if CRC8 check failed and true if successful
+  //Baseline reads and acknowledged writes are remembered for reinitialize()
   SGP30ERR getBaseline(void);
+  SGP30ERR readBaseline(void);
+  SGP30ERR setBaseline(uint16_t baselineCO2, uint16_t baselineTVOC);
 
-  //Updates the baseline to a previous baseline
-  //Should only use with previously retrieved baselines
-  //to maintain accuracy
-  void setBaseline(uint16_t baselineCO2, uint16_t baselineTVOC);
-
-  //Set humidity
-  //humidity value is a fixed point 8.8 bit number
-  //Value should be absolute humidity from humidity sensor
-  //default value 0x0F80 = 15.5g/m^3
-  //minimum value 0x0001 = 1/256g/m^3
-  //maximum value 0xFFFF = 255+255/256 g/m^3
-  //sending 0x0000 resets to default and turns off humidity compensation
-  void setHumidity(uint16_t humidity);
-
-  //gives feature set version number (see data sheet)
-  //returns false if CRC8 check failed and true if successful
-  SGP30ERR getFeatureSetVersion(void);
-
-  //Intended for part verification and testing
-  //these raw signals are used as inputs to the onchip calibrations and algorithms
+  //Raw signals also feed the snapshot, history and alerts
   SGP30ERR measureRawSignals(void);
+  SGP30ERR readRawSignals(void);
+
+  //Every other command, blocking and split-phase, and isReady(), isBusy()
+  //and msUntilReady() come from the features and SGP30Core
+
+  //Consistent copy of every result for other tasks, threads and ISRs
+  //(see SparkFun_SGP30_Snapshot.h), published after each successful
+  //measurement, a baseline read shows up with the next one
+  //The public fields above are kept for single threaded sketches
+  //Wait-free, returns false if a snapshot is being published: try again later
+  bool tryReadSnapshot(SGP30Snapshot &snapshot) const;
+  //Retries until it succeeds, from ISRs or higher priority tasks use tryReadSnapshot()
+  void readSnapshot(SGP30Snapshot &snapshot) const;
+
+  //Hooks, see SparkFun_SGP30_Observer.h: only the ones a sketch creates are linked
+  //Records every successful measurement in history (see SparkFun_SGP30_History.h)
+  //sources selects the measurements that add a sample:
+  //SGP30_HISTORY_AIR_QUALITY and/or SGP30_HISTORY_RAW_SIGNALS
+  void attachHistory(SGP30HistoryBase &history, uint8_t sources = SGP30_HISTORY_AIR_QUALITY);
+  void detachHistory(SGP30HistoryBase &history);
+
+  //Evaluates alert rules on every successful measurement (see SparkFun_SGP30_Alerts.h)
+  void attachAlerts(SGP30AlertsBase &alerts);
+  void detachAlerts(SGP30AlertsBase &alerts);
+
+  //Saves the baseline on a schedule and restores it on initAirQuality()
+  //(see SparkFun_SGP30_Baseline.h), call before initAirQuality()
+  void attachBaselineManager(SGP30BaselineManager &manager);
+  void detachBaselineManager(SGP30BaselineManager &manager);
+
+  //Retries failed measurements and re-initializes the sensor when they
+  //keep failing (see SparkFun_SGP30_Recovery.h), call before initAirQuality()
+  void attachRecovery(SGP30Recovery &recovery);
+  void detachRecovery(SGP30Recovery &recovery);
+
+  //Records every bus transaction (see SparkFun_SGP30_Trace.h): the recorder
+  //goes in front of the transport, before or after begin()
+  void attachRecorder(SGP30TraceRecorder &recorder);
+  void detachRecorder(void);
+
+  //Resets the sensor and brings it back: general call reset, begin(),
+  //initAirQuality(), then the last baseline set or read and the last
+  //humidity set are written back
+  //Returns false if the sensor did not answer after the reset or did not
+  //acknowledge the init or the writes after it
+  bool reinitialize(void);
+
+private:
+  typedef BasicSGP30<SGP30_ALL_FEATURES> Basic;
 
-  //Soft reset - not device specific
-  //will reset all devices that support general call mode
-  void generalCallReset(void);
+  //History, alerts, baseline manager, recovery... in the order attached
+  SGP30Observer *_observers;
 
-  //readout of serial ID register can identify chip and verify sensor presence
-  //returns false if CRC8 check failed and true if successful
-  SGP30ERR getSerialID(void);
+  void _attach(SGP30Observer &observer);
+  void _detach(SGP30Observer &observer);
 
-  //Sensor runs on chip self test
-  //returns true if successful
-  SGP30ERR measureTest(void);
+  //Hands the published values to every observer, source is SGP30_HISTORY_*
+  void _notify(uint8_t source);
 
-private:
-  //This stores the requested i2c port
-  TwoWire *_i2cPort;
-
-  //SGP30's I2C address
-  const byte _SGP30Address = 0x58;
-
-  //Generates CRC8 for SGP30 from lookup table
-  uint8_t _CRC8(uint16_t twoBytes);
-
-#ifdef SGP30_LOOKUP_TABLE
-  //lookup table for CRC8  http://www.sunshine2k.de/coding/javascript/crc/crc_js.html
-  const uint8_t _CRC8LookupTable[16][16] = {
-      {0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E},
-      {0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D},
-      {0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8},
-      {0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB},
-      {0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13},
-      {0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50},
-      {0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95},
-      {0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6},
-      {0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54},
-      {0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17},
-      {0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2},
-      {0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91},
-      {0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69},
-      {0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A},
-      {0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF},
-      {0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC}};
-#endif
+  //Results as of the last successful read, for concurrent readers
+  SGP30SnapshotCell _snapshot;
+
+  //Publishes the current results to _snapshot
+  void _publish(void);
+
+  //Optional bus recorder in front of the transport, NULL if not attached
+  SGP30TraceRecorder *_recorder;
+
+  bool _fastStartup;
+
+  //Last baseline written to or read from the sensor, for reinitialize()
+  uint16_t _knownBaselineCO2;
+  uint16_t _knownBaselineTVOC;
+  bool _baselineKnown;
+
+  //Hooks run on the outcome of each command
+  //lastCO2 and lastTVOC are the values from before an air quality reading
+  SGP30ERR _airQuality(SGP30ERR error, uint16_t lastCO2, uint16_t lastTVOC);
+  SGP30ERR _baseline(SGP30ERR error);
+  SGP30ERR _rawSignals(SGP30ERR error);
 };
 
 #endif
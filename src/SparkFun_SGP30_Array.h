@@ -0,0 +1,285 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Every SGP30 answers on the same fixed address (0x58), so only one fits on
+  each bus. SGP30Array drives several of them through TCA9548A style I2C
+  multiplexers and pipelines their measurements: the command is sent to every
+  sensor back to back and all results are collected after a single wait.
+  Each sensor talks through its own transport, which routes the bus to its
+  channel first, so any call on sensors[i] (getBaseline(), setHumidity(),
+  recovery...) reaches the right sensor, not the one selected last.
+*/
+
+#ifndef SparkFun_SGP30_Array_h
+#define SparkFun_SGP30_Array_h
+
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+//Default address of the first TCA9548A multiplexer
+//Channels 0-7 are on the mux at muxAddress, 8-15 on muxAddress+1 and so on
+#define SGP30_MUX_ADDRESS 0x70
+#define SGP30_MUX_CHANNELS 8
+
+//Channel value for a sensor wired directly to the bus, no mux in between
+#define SGP30_NO_MUX_CHANNEL 0xFE
+
+//Mux state after power up or an error, forces the next select to be written
+#define SGP30_MUX_UNKNOWN 0xFF
+
+template <uint8_t N>
+class SGP30Array
+{
+public:
+  //One driver per sensor, results are published in each sensor's fields
+  //Every call on a sensor selects its channel first
+  SGP30 sensors[N];
+
+  //Result of the last operation on each sensor
+  SGP30ERR status[N];
+
+  //default constructor
+  //sensor i is on mux channel i unless changed with setChannel()
+  SGP30Array();
+
+  //Assigns a mux channel to a sensor, call before begin()
+  void setChannel(uint8_t sensor, uint8_t channel);
+
+  //Start I2C communication with every sensor using specified port
+  //Returns the number of sensors detected
+  uint8_t begin(TwoWire &wirePort = Wire, uint8_t muxAddress = SGP30_MUX_ADDRESS);
+
+  //Same over any transport (see SparkFun_SGP30_Transport.h)
+  uint8_t begin(SGP30Transport &transport, uint8_t muxAddress = SGP30_MUX_ADDRESS);
+
+  //Initializes every sensor for air quality readings, see status[] for any
+  //that did not take the command
+  void initAirQuality(void);
+
+  //Measures air quality on every sensor, waiting only once for all of them
+  //Call in regular intervals of 1 second
+  //Returns the number of sensors read successfully, see status[] for the others
+  uint8_t measureAirQuality(void);
+
+  //Non-blocking versions of measureAirQuality()
+  //startAirQuality() sends the command to every sensor back to back
+  //isReady() returns true once the last sensor started has finished
+  //readAirQuality() collects every result and returns the number read successfully
+  void startAirQuality(void);
+  bool isReady(void);
+  uint8_t readAirQuality(void);
+
+private:
+  //Transport of one sensor: routes the bus to its channel before every transaction
+  class Channel : public SGP30Transport
+  {
+  public:
+    SGP30Array *array;
+    uint8_t sensor;
+
+    bool write(uint8_t address, const uint8_t *data, uint8_t length)
+    {
+      return array->_select(sensor) && array->_transport->write(address, data, length);
+    }
+
+    bool read(uint8_t address, uint8_t *data, uint8_t length)
+    {
+      return array->_select(sensor) && array->_transport->read(address, data, length);
+    }
+  };
+
+  //Shared by the muxes and every sensor
+  SGP30Transport *_transport;
+
+  //What each sensor is begun on
+  Channel _channels[N];
+
+  //Adapter used by begin(TwoWire&)
+  SGP30TwoWireTransport _wire;
+
+  //Address of the first multiplexer and how many are in use
+  uint8_t _muxAddress;
+  uint8_t _muxCount;
+
+  //Mux channel of each sensor
+  uint8_t _channel[N];
+
+  //Channel currently selected, so repeated selects are not written
+  uint8_t _selectedChannel;
+
+  //Routes the bus to a sensor, returns false if the mux did not acknowledge
+  bool _select(uint8_t sensor);
+
+  //Writes a channel mask to one mux
+  bool _writeMux(uint8_t mux, uint8_t mask);
+};
+
+template <uint8_t N>
+SGP30Array<N>::SGP30Array()
+{
+  for (uint8_t i = 0; i < N; i++)
+  {
+    status[i] = SGP30_SUCCESS;
+    _channel[i] = i;
+    _channels[i].array = this;
+    _channels[i].sensor = i;
+  }
+  _transport = &_wire;
+  _muxAddress = SGP30_MUX_ADDRESS;
+  _muxCount = 0;
+  _selectedChannel = SGP30_MUX_UNKNOWN;
+}
+
+//Assigns a mux channel to a sensor, call before begin()
+template <uint8_t N>
+void SGP30Array<N>::setChannel(uint8_t sensor, uint8_t channel)
+{
+  if (sensor < N)
+    _channel[sensor] = channel;
+}
+
+//Start I2C communication with every sensor using specified port
+//Returns the number of sensors detected
+template <uint8_t N>
+uint8_t SGP30Array<N>::begin(TwoWire &wirePort, uint8_t muxAddress)
+{
+  _wire.setPort(wirePort);
+  return begin(_wire, muxAddress);
+}
+
+//Start communication with every sensor over any transport
+//Returns the number of sensors detected
+template <uint8_t N>
+uint8_t SGP30Array<N>::begin(SGP30Transport &transport, uint8_t muxAddress)
+{
+  _transport = &transport;
+  _muxAddress = muxAddress;
+  //Close every mux in use so no two sensors share the bus
+  _muxCount = 0;
+  for (uint8_t i = 0; i < N; i++)
+    if (_channel[i] != SGP30_NO_MUX_CHANNEL && _channel[i] / SGP30_MUX_CHANNELS >= _muxCount)
+      _muxCount = _channel[i] / SGP30_MUX_CHANNELS + 1;
+  _selectedChannel = SGP30_MUX_UNKNOWN;
+
+  uint8_t found = 0;
+  for (uint8_t i = 0; i < N; i++)
+  {
+    if (sensors[i].begin(_channels[i]) == false)
+      status[i] = SGP30_ERR_I2C_TIMEOUT;
+    else
+    {
+      status[i] = SGP30_SUCCESS;
+      found++;
+    }
+  }
+  return found;
+}
+
+//Initializes every sensor for air quality readings
+template <uint8_t N>
+void SGP30Array<N>::initAirQuality(void)
+{
+  for (uint8_t i = 0; i < N; i++)
+    status[i] = sensors[i].initAirQuality();
+}
+
+//Measures air quality on every sensor, waiting only once for all of them
+//Returns the number of sensors read successfully
+template <uint8_t N>
+uint8_t SGP30Array<N>::measureAirQuality(void)
+{
+  startAirQuality();
+  //Sensors were started in order, so by the time the last one is ready all are
+  for (uint8_t i = N; i > 0; i--)
+  {
+    if (sensors[i - 1].isBusy())
+    {
+      while (!sensors[i - 1].isReady())
+        delay(sensors[i - 1].msUntilReady());
+      break;
+    }
+  }
+  return readAirQuality();
+}
+
+//Sends the measure command to every sensor back to back
+template <uint8_t N>
+void SGP30Array<N>::startAirQuality(void)
+{
+  for (uint8_t i = 0; i < N; i++)
+    status[i] = sensors[i].startAirQuality();
+}
+
+//Returns true once every sensor that was started has finished
+template <uint8_t N>
+bool SGP30Array<N>::isReady(void)
+{
+  for (uint8_t i = 0; i < N; i++)
+    if (sensors[i].isBusy() && !sensors[i].isReady())
+      return false;
+  return true;
+}
+
+//Collects every result started by startAirQuality()
+//Returns the number of sensors read successfully
+template <uint8_t N>
+uint8_t SGP30Array<N>::readAirQuality(void)
+{
+  uint8_t good = 0;
+  for (uint8_t i = 0; i < N; i++)
+  {
+    if (status[i] != SGP30_SUCCESS)
+      continue; //start failed, nothing to collect
+    status[i] = sensors[i].readAirQuality();
+    if (status[i] == SGP30_SUCCESS)
+      good++;
+  }
+  return good;
+}
+
+//Routes the bus to a sensor, before each of its transactions
+//Only writes to the mux(es) when the channel actually changes
+template <uint8_t N>
+bool SGP30Array<N>::_select(uint8_t sensor)
+{
+  uint8_t channel = _channel[sensor];
+  if (channel == _selectedChannel)
+    return true;
+  uint8_t mux = channel / SGP30_MUX_CHANNELS;
+  if (_selectedChannel == SGP30_MUX_UNKNOWN)
+  {
+    //Don't know what is open, close every other mux
+    for (uint8_t other = 0; other < _muxCount; other++)
+    {
+      if ((channel == SGP30_NO_MUX_CHANNEL || other != mux) && !_writeMux(other, 0))
+        return false;
+    }
+  }
+  //Close the previous mux if the new channel lives on a different one
+  else if (_selectedChannel != SGP30_NO_MUX_CHANNEL &&
+           (channel == SGP30_NO_MUX_CHANNEL || _selectedChannel / SGP30_MUX_CHANNELS != mux))
+  {
+    if (!_writeMux(_selectedChannel / SGP30_MUX_CHANNELS, 0))
+    {
+      _selectedChannel = SGP30_MUX_UNKNOWN;
+      return false;
+    }
+  }
+  if (channel != SGP30_NO_MUX_CHANNEL &&
+      !_writeMux(mux, 1 << (channel % SGP30_MUX_CHANNELS)))
+  {
+    _selectedChannel = SGP30_MUX_UNKNOWN;
+    return false;
+  }
+  _selectedChannel = channel;
+  return true;
+}
+
+//Writes a channel mask to one mux
+template <uint8_t N>
+bool SGP30Array<N>::_writeMux(uint8_t mux, uint8_t mask)
+{
+  return _transport->write((uint8_t)(_muxAddress + mux), &mask, 1);
+}
+
+#endif
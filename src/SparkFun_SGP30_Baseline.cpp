@@ -0,0 +1,254 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Baseline persistence for the SGP30, see SparkFun_SGP30_Baseline.h
+*/
+
+#include "SparkFun_SGP30_Baseline.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+#define SGP30_BASELINE_MARKER 0xB5
+
+//Big endian field helpers for the record layout
+static void _put(uint8_t *record, uint8_t offset, uint64_t value, uint8_t bytes)
+{
+  while (bytes--)
+  {
+    record[offset + bytes] = (uint8_t)value;
+    value >>= 8;
+  }
+}
+
+static uint64_t _get(const uint8_t *record, uint8_t offset, uint8_t bytes)
+{
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < bytes; i++)
+    value = (value << 8) | record[offset + i];
+  return value;
+}
+
+SGP30BaselineManager::SGP30BaselineManager(SGP30BaselineStorage &storage)
+{
+  _storage = &storage;
+  _clock = NULL;
+  _maxAge = 7UL * 24 * 60 * 60;
+  _firstSave = 12UL * 60 * 60 * 1000;
+  _everySave = 60UL * 60 * 1000;
+  _initTime = 0;
+  _lastSave = 0;
+  _saved = false;
+  _restored = false;
+  _serialID = 0;
+  _initialized = false;
+  _sequence = 0;
+  _nextSlot = 0;
+  _storedCO2 = 0;
+  _storedTVOC = 0;
+  _storedTime = 0;
+  _stored = false;
+  writes = 0;
+}
+
+//Seconds clock used to tag records and reject stale ones
+void SGP30BaselineManager::setClock(unsigned long (*seconds)(void))
+{
+  _clock = seconds;
+}
+
+//Records older than this are not restored
+void SGP30BaselineManager::setMaxAge(unsigned long seconds)
+{
+  _maxAge = seconds;
+}
+
+//Time from init to the first save and between saves, in ms
+void SGP30BaselineManager::setInterval(unsigned long firstSave, unsigned long everySave)
+{
+  _firstSave = firstSave;
+  _everySave = everySave;
+}
+
+//Restores the newest valid baseline for this sensor
+//Called by SGP30::initAirQuality() right after the init command
+//Later inits of the same sensor (reinitialize(), a self test) keep the
+//live baseline, which the driver puts back itself, and the save schedule
+void SGP30BaselineManager::onInit(SGP30 &sensor)
+{
+  if (_initialized && sensor.serialID == _serialID)
+    return;
+  _initialized = true;
+  _serialID = sensor.serialID;
+  _initTime = millis();
+  _saved = false;
+  _restored = false;
+  uint16_t baselineCO2, baselineTVOC;
+  unsigned long time;
+  _stored = _scan(sensor.serialID, &baselineCO2, &baselineTVOC, &time);
+  if (!_stored)
+    return;
+  _storedCO2 = baselineCO2;
+  _storedTVOC = baselineTVOC;
+  _storedTime = time;
+  //A record without a time can't be aged, only trust it if we have no clock either
+  if (_clock != NULL && (time == 0 || _clock() - time > _maxAge))
+    return; //stale, calibrate from scratch
+  delay(10); //init_air_quality takes up to 10ms
+  _restored = sensor.setBaseline(baselineCO2, baselineTVOC) == SGP30_SUCCESS;
+  delay(10); //and so does set_baseline, the sensor won't answer until it is done
+}
+
+//Saves the baseline when due, called after every measurement
+void SGP30BaselineManager::onSample(SGP30 &sensor, const SGP30Sample &, uint8_t source)
+{
+  if (source != SGP30_HISTORY_AIR_QUALITY)
+    return;
+  unsigned long now = millis();
+  unsigned long since = (uint32_t)(now - (_saved ? _lastSave : _initTime));
+  //The datasheet asks for 12 hours of operation before the first baseline is trusted
+  unsigned long due = (_saved || _restored) ? _everySave : _firstSave;
+  if (since < due)
+    return;
+  _lastSave = now;
+  _saved = true; //a failed save is retried at the next interval
+  save(sensor);
+}
+
+//Reads the baseline from the sensor and stores it if it has changed
+//An unchanged baseline is only rewritten when its record is half way to stale
+//The region is scanned again first: another manager (another sensor) may
+//share it and have written since
+bool SGP30BaselineManager::save(SGP30 &sensor)
+{
+  if (sensor.getBaseline() != SGP30_SUCCESS)
+    return false;
+  uint16_t baselineCO2, baselineTVOC;
+  unsigned long time;
+  _stored = _scan(sensor.serialID, &baselineCO2, &baselineTVOC, &time);
+  if (_stored)
+  {
+    _storedCO2 = baselineCO2;
+    _storedTVOC = baselineTVOC;
+    _storedTime = time;
+  }
+  if (_stored && sensor.baselineCO2 == _storedCO2 && sensor.baselineTVOC == _storedTVOC &&
+      (_clock == NULL || _clock() - _storedTime < _maxAge / 2))
+    return false;
+  return _write(sensor.serialID, sensor.baselineCO2, sensor.baselineTVOC);
+}
+
+//Records that fit in the region, none straddles a flash page
+uint16_t SGP30BaselineManager::_slots(void)
+{
+  uint16_t page = _storage->pageSize();
+  if (page == 0)
+    return _storage->size() / SGP30_BASELINE_RECORD_SIZE;
+  //One page must keep the newest record while another is erased
+  if (page < SGP30_BASELINE_RECORD_SIZE || _storage->size() / page < 2)
+    return 0;
+  return (_storage->size() / page) * (page / SGP30_BASELINE_RECORD_SIZE);
+}
+
+uint16_t SGP30BaselineManager::_address(uint16_t slot)
+{
+  uint16_t page = _storage->pageSize();
+  if (page == 0)
+    return slot * SGP30_BASELINE_RECORD_SIZE;
+  uint16_t perPage = page / SGP30_BASELINE_RECORD_SIZE;
+  return (slot / perPage) * page + (slot % perPage) * SGP30_BASELINE_RECORD_SIZE;
+}
+
+//True if every byte from address on is erased
+bool SGP30BaselineManager::_blank(uint16_t address, uint16_t length)
+{
+  uint8_t chunk[SGP30_BASELINE_RECORD_SIZE];
+  while (length > 0)
+  {
+    uint8_t size = length < sizeof(chunk) ? length : sizeof(chunk);
+    _storage->read(address, chunk, size);
+    for (uint8_t i = 0; i < size; i++)
+    {
+      if (chunk[i] != 0xFF)
+        return false;
+    }
+    address += size;
+    length -= size;
+  }
+  return true;
+}
+
+//Walks every slot once, remembering the newest record overall (so the next
+//write goes after it) and the newest one belonging to serialID
+bool SGP30BaselineManager::_scan(uint64_t serialID, uint16_t *baselineCO2, uint16_t *baselineTVOC, unsigned long *time)
+{
+  uint8_t record[SGP30_BASELINE_RECORD_SIZE];
+  uint16_t slots = _slots();
+  uint32_t newestMine = 0;
+  _sequence = 0;
+  _nextSlot = 0;
+  for (uint16_t slot = 0; slot < slots; slot++)
+  {
+    _storage->read(_address(slot), record, SGP30_BASELINE_RECORD_SIZE);
+    if (record[0] != SGP30_BASELINE_MARKER ||
+        sgp30CRC8(record, SGP30_BASELINE_RECORD_SIZE - 1) != record[SGP30_BASELINE_RECORD_SIZE - 1])
+      continue; //blank or damaged
+    uint32_t sequence = (uint32_t)_get(record, 1, 4);
+    if (sequence > _sequence)
+    {
+      _sequence = sequence;
+      _nextSlot = (slot + 1) % slots;
+    }
+    if (_get(record, 9, 6) == (serialID & 0xFFFFFFFFFFFFULL) && sequence > newestMine)
+    {
+      newestMine = sequence;
+      *time = (unsigned long)_get(record, 5, 4);
+      *baselineCO2 = (uint16_t)_get(record, 15, 2);
+      *baselineTVOC = (uint16_t)_get(record, 17, 2);
+    }
+  }
+  return newestMine != 0;
+}
+
+//Appends a record in the slot after the newest one
+bool SGP30BaselineManager::_write(uint64_t serialID, uint16_t baselineCO2, uint16_t baselineTVOC)
+{
+  uint16_t slots = _slots();
+  if (slots == 0)
+    return false;
+  //Flash can only be rewritten after an erase: erase a used page just before
+  //its first slot is reused, the newest record is at the end of another page
+  uint16_t page = _storage->pageSize();
+  uint16_t address = _address(_nextSlot);
+  if (page != 0 && address % page != 0 && !_blank(address, SGP30_BASELINE_RECORD_SIZE))
+  {
+    //Leftovers mid-page (a write cut short): erasing this page would take the
+    //newest record with it, carry on at the start of the next page instead
+    uint16_t perPage = page / SGP30_BASELINE_RECORD_SIZE;
+    _nextSlot = (uint16_t)(((_nextSlot / perPage + 1) * perPage) % slots);
+    address = _address(_nextSlot);
+  }
+  if (page != 0 && address % page == 0 && !_blank(address, page))
+  {
+    if (!_storage->erase(address))
+      return false;
+  }
+  unsigned long time = _clock ? _clock() : 0;
+  uint8_t record[SGP30_BASELINE_RECORD_SIZE];
+  record[0] = SGP30_BASELINE_MARKER;
+  _put(record, 1, _sequence + 1, 4);
+  _put(record, 5, time, 4);
+  _put(record, 9, serialID, 6);
+  _put(record, 15, baselineCO2, 2);
+  _put(record, 17, baselineTVOC, 2);
+  record[SGP30_BASELINE_RECORD_SIZE - 1] = sgp30CRC8(record, SGP30_BASELINE_RECORD_SIZE - 1);
+  if (!_storage->write(address, record, SGP30_BASELINE_RECORD_SIZE))
+    return false;
+  _sequence++;
+  _nextSlot = (_nextSlot + 1) % slots;
+  _storedCO2 = baselineCO2;
+  _storedTVOC = baselineTVOC;
+  _storedTime = time;
+  _stored = true;
+  writes++;
+  return true;
+}
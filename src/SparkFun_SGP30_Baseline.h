@@ -0,0 +1,128 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Baseline persistence for the SGP30.
+  Without a stored baseline the sensor needs about 12 hours to calibrate
+  after every power up. SGP30BaselineManager saves the baseline on a
+  schedule and restores it on the first initAirQuality():
+    - first save 12 hours after init (1 hour if a baseline was restored),
+      then every hour, as recommended by the datasheet
+    - records are only written when the baseline has changed, or to
+      refresh an old record before it goes stale
+    - records rotate through every slot of the storage region (wear
+      leveling) and carry a sequence number, a CRC, the sensor's serial ID
+      and the time they were taken
+    - on restore the newest valid record for this sensor is used, unless it
+      is older than a week (the datasheet's limit) according to the clock
+      given with setClock(); with no clock, age is not checked
+    - on flash a page is only erased just before its first slot is reused,
+      the newest record is always in another page and survives a power
+      loss between the erase and the write; a slot left dirty by an
+      interrupted write is skipped along with the rest of its page
+    - several managers (one per sensor) may share a region, the region is
+      scanned again before every write
+  Storage is pluggable, see SGP30BaselineStorage and SparkFun_SGP30_EEPROM.h
+*/
+
+#ifndef SparkFun_SGP30_Baseline_h
+#define SparkFun_SGP30_Baseline_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_Observer.h"
+
+//Size of one stored record
+//marker / sequence(4) / time(4) / serial ID(6) / baseline CO2(2) / baseline TVOC(2) / CRC
+#define SGP30_BASELINE_RECORD_SIZE 20
+
+//A region of non-volatile memory holding baseline records
+//EEPROM style storage can rewrite any byte: keep pageSize() at 0
+//Flash style storage can only write erased bytes: return the erase page size
+//from pageSize() and implement erase(), which must leave every byte of one
+//page at 0xFF. The region must hold at least two pages of one record or more
+class SGP30BaselineStorage
+{
+public:
+  //Size of the region in bytes
+  virtual uint16_t size(void) = 0;
+
+  //Reads length bytes starting at address (relative to the region)
+  virtual void read(uint16_t address, uint8_t *data, uint8_t length) = 0;
+
+  //Writes length bytes starting at address, returns false on failure
+  virtual bool write(uint16_t address, const uint8_t *data, uint8_t length) = 0;
+
+  //Flash backends: bytes erased at once, 0 if any byte can be rewritten
+  virtual uint16_t pageSize(void) { return 0; }
+
+  //Flash backends: erases the page starting at address, returns false on failure
+  virtual bool erase(uint16_t) { return true; }
+};
+
+class SGP30BaselineManager : public SGP30Observer
+{
+public:
+  //Number of records written, to keep an eye on wear
+  unsigned long writes;
+
+  SGP30BaselineManager(SGP30BaselineStorage &storage);
+
+  //Seconds clock (RTC, NTP...) used to tag records and reject stale ones
+  void setClock(unsigned long (*seconds)(void));
+
+  //Records older than this are not restored, default 7 days
+  void setMaxAge(unsigned long seconds);
+
+  //Time from init to the first save and between saves, default 12 h and 1 h
+  void setInterval(unsigned long firstSave, unsigned long everySave);
+
+  //Called by SGP30::initAirQuality(), restores the newest valid baseline
+  //on the first init of a sensor only
+  void onInit(SGP30 &sensor);
+
+  //Called by SGP30 after every measurement, saves when due
+  void onSample(SGP30 &sensor, const SGP30Sample &sample, uint8_t source);
+
+  //Reads the baseline from the sensor and stores it if it has changed
+  //Returns true if a record was written
+  bool save(SGP30 &sensor);
+
+  //True if the first init restored a baseline
+  bool restored(void) { return _restored; }
+
+private:
+  SGP30BaselineStorage *_storage;
+  unsigned long (*_clock)(void);
+  unsigned long _maxAge;
+  unsigned long _firstSave;
+  unsigned long _everySave;
+
+  unsigned long _initTime; //millis() at init
+  unsigned long _lastSave; //millis() at the last save
+  bool _saved;             //saved at least once since init
+  bool _restored;
+  uint64_t _serialID; //sensor of the first init
+  bool _initialized;
+
+  //Newest record in storage and where the next one goes, as of the last scan
+  uint32_t _sequence;
+  uint16_t _nextSlot;
+
+  //Last record written for this sensor, to skip identical writes
+  uint16_t _storedCO2;
+  uint16_t _storedTVOC;
+  unsigned long _storedTime;
+  bool _stored;
+
+  uint16_t _slots(void);
+  uint16_t _address(uint16_t slot);
+  bool _blank(uint16_t address, uint16_t length);
+
+  //Finds the newest record (any sensor) and the newest for serialID
+  //Returns true if one for serialID was found
+  bool _scan(uint64_t serialID, uint16_t *baselineCO2, uint16_t *baselineTVOC, unsigned long *time);
+
+  bool _write(uint64_t serialID, uint16_t baselineCO2, uint16_t baselineTVOC);
+};
+
+#endif
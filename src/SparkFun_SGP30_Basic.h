@@ -0,0 +1,416 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+  The command methods were moved here from
+  SparkFun_SGP30_Arduino_Library.cpp, by Ciara Jekel @ SparkFun
+  Electronics, June 18th, 2018
+
+  Compile time configuration of the driver, for parts with little RAM.
+
+  BasicSGP30<> only measures air quality (CO2 and TVOC). Each feature
+  listed adds its fields and commands, in any order:
+
+    BasicSGP30<SGP30Baselines, SGP30HumidityCompensation> mySensor;
+
+    SGP30RawSignals           H2, ethanol, measure/start/readRawSignals()
+    SGP30SerialID             serialID, get/start/readSerialID()
+    SGP30FeatureSet           featureSetVersion, get/start/readFeatureSetVersion()
+    SGP30SelfTest             measure/start/readTest()
+    SGP30Baselines            baselineCO2, baselineTVOC, get/start/readBaseline(), setBaseline()
+    SGP30HumidityCompensation setHumidity(), setRelativeHumidity(), setHumidityHysteresis()
+
+  A feature that isn't listed takes no RAM, and its commands are not
+  compiled in: they are templates, generated only when called. SGP30 is
+  BasicSGP30<SGP30_ALL_FEATURES> with the hooks (history, alerts, baseline
+  manager, recovery, snapshots) layered on top, so every command exists
+  once. Its begin() also reads the serial ID and the feature set, which
+  tells the capabilities of the chip.
+*/
+
+#ifndef SparkFun_SGP30_Basic_h
+#define SparkFun_SGP30_Basic_h
+
+#include "SparkFun_SGP30_Core.h"
+#include "SparkFun_SGP30_Humidity.h"
+
+//Every feature, BasicSGP30<SGP30_ALL_FEATURES>
+#define SGP30_ALL_FEATURES SGP30RawSignals, SGP30SerialID, SGP30FeatureSet, SGP30SelfTest, \
+                           SGP30Baselines, SGP30HumidityCompensation
+
+template <class Base>
+class SGP30RawSignals : public Base
+{
+public:
+  uint16_t H2;
+  uint16_t ethanol;
+
+  SGP30RawSignals();
+
+  //Intended for part verification and testing
+  //these raw signals are used as inputs to the onchip calibrations and algorithms
+  SGP30ERR measureRawSignals(void);
+  SGP30ERR startRawSignals(void);
+  SGP30ERR readRawSignals(void);
+
+private:
+  SGP30ERR _publishRawSignals(SGP30ERR error, const uint16_t words[2]);
+};
+
+template <class Base>
+class SGP30SerialID : public Base
+{
+public:
+  uint64_t serialID;
+
+  SGP30SerialID();
+
+  //readout of serial ID register can identify chip and verify sensor presence
+  SGP30ERR getSerialID(void);
+  SGP30ERR startSerialID(void);
+  SGP30ERR readSerialID(void);
+
+private:
+  SGP30ERR _publishSerialID(SGP30ERR error, const uint16_t words[3]);
+};
+
+template <class Base>
+class SGP30FeatureSet : public Base
+{
+public:
+  uint16_t featureSetVersion;
+
+  SGP30FeatureSet();
+
+  //gives feature set version number (see data sheet)
+  SGP30ERR getFeatureSetVersion(void);
+  SGP30ERR startFeatureSetVersion(void);
+  SGP30ERR readFeatureSetVersion(void);
+};
+
+template <class Base>
+class SGP30SelfTest : public Base
+{
+public:
+  //Sensor runs on chip self test
+  //Returns SGP30_SELF_TEST_FAIL if the sensor reports a failure
+  SGP30ERR measureTest(void);
+  SGP30ERR startTest(void);
+  SGP30ERR readTest(void);
+
+private:
+  static SGP30ERR _testResult(SGP30ERR error, uint16_t result);
+};
+
+template <class Base>
+class SGP30Baselines : public Base
+{
+public:
+  uint16_t baselineCO2;
+  uint16_t baselineTVOC;
+
+  SGP30Baselines();
+
+  //Returns the current calculated baseline from
+  //the sensor's dynamic baseline calculations
+  SGP30ERR getBaseline(void);
+  SGP30ERR startBaseline(void);
+  SGP30ERR readBaseline(void);
+
+  //Updates the baseline to a previous baseline
+  //Returns SGP30_ERR_I2C_TIMEOUT if the sensor did not acknowledge it, or
+  //SGP30_ERR_BUSY while a started command has not been read
+  SGP30ERR setBaseline(uint16_t baselineCO2, uint16_t baselineTVOC);
+
+private:
+  SGP30ERR _publishBaseline(SGP30ERR error, const uint16_t words[2]);
+};
+
+template <class Base>
+class SGP30HumidityCompensation : public Base
+{
+public:
+  SGP30HumidityCompensation();
+
+  //Sets humidity compensation, absolute humidity in g/m^3 as 8.8 fixed point
+  //default value 0x0F80 = 15.5g/m^3, from 0x0001 = 1/256g/m^3 to 0xFFFF
+  //sending 0x0000 resets to default and turns off humidity compensation
+  //Returns SGP30_ERR_I2C_TIMEOUT or SGP30_ERR_BUSY like setBaseline(), the
+  //value is only remembered once the sensor has acknowledged it
+  SGP30ERR setHumidity(uint16_t humidity);
+
+  //Humidity compensation from temperature (centi-degrees C) and relative humidity (0.01%)
+  //Returns true if the sensor was updated
+  bool setRelativeHumidity(int16_t temperature, uint16_t relativeHumidity);
+
+  //Change in absolute humidity that setRelativeHumidity() ignores
+  void setHumidityHysteresis(uint16_t hysteresis);
+
+  //Soft reset, also turns humidity compensation off
+  void generalCallReset(void);
+
+protected:
+  //Last humidity sent to the sensor, for the hysteresis and SGP30::reinitialize()
+  uint16_t _humidity;
+  bool _humiditySet;
+
+private:
+  uint16_t _humidityHysteresis;
+};
+
+//Nests the features: BasicSGP30<A, B> derives from A<B<SGP30Core> >
+template <template <class> class... Features>
+struct _SGP30Chain;
+
+template <>
+struct _SGP30Chain<>
+{
+  typedef SGP30Core type;
+};
+
+template <template <class> class Feature, template <class> class... Features>
+struct _SGP30Chain<Feature, Features...>
+{
+  typedef Feature<typename _SGP30Chain<Features...>::type> type;
+};
+
+template <template <class> class... Features>
+class BasicSGP30 : public _SGP30Chain<Features...>::type
+{
+};
+
+template <class Base>
+SGP30RawSignals<Base>::SGP30RawSignals()
+{
+  H2 = 0;
+  ethanol = 0;
+}
+
+//datasheet says 20-25ms
+template <class Base>
+SGP30ERR SGP30RawSignals<Base>::measureRawSignals(void)
+{
+  uint16_t words[2];
+  return _publishRawSignals(this->_measure(measure_raw_signals, 25, words, 2), words);
+}
+
+template <class Base>
+SGP30ERR SGP30RawSignals<Base>::startRawSignals(void)
+{
+  return this->_startCommand(measure_raw_signals, 25);
+}
+
+template <class Base>
+SGP30ERR SGP30RawSignals<Base>::readRawSignals(void)
+{
+  uint16_t words[2];
+  return _publishRawSignals(this->_read(measure_raw_signals, words, 2), words);
+}
+
+template <class Base>
+SGP30ERR SGP30RawSignals<Base>::_publishRawSignals(SGP30ERR error, const uint16_t words[2])
+{
+  if (error != SGP30_SUCCESS)
+    return error;
+  H2 = words[0];      //publish valid data
+  ethanol = words[1]; //publish valid data
+  return SGP30_SUCCESS;
+}
+
+template <class Base>
+SGP30SerialID<Base>::SGP30SerialID()
+{
+  serialID = 0;
+}
+
+//datasheet says 0.5ms
+template <class Base>
+SGP30ERR SGP30SerialID<Base>::getSerialID(void)
+{
+  uint16_t words[3];
+  return _publishSerialID(this->_measure(get_serial_id, 1, words, 3), words);
+}
+
+template <class Base>
+SGP30ERR SGP30SerialID<Base>::startSerialID(void)
+{
+  return this->_startCommand(get_serial_id, 1);
+}
+
+template <class Base>
+SGP30ERR SGP30SerialID<Base>::readSerialID(void)
+{
+  uint16_t words[3];
+  return _publishSerialID(this->_read(get_serial_id, words, 3), words);
+}
+
+template <class Base>
+SGP30ERR SGP30SerialID<Base>::_publishSerialID(SGP30ERR error, const uint16_t words[3])
+{
+  if (error != SGP30_SUCCESS)
+    return error;
+  serialID = ((uint64_t)words[0] << 32) + ((uint64_t)words[1] << 16) + ((uint64_t)words[2]); //publish valid data
+  return SGP30_SUCCESS;
+}
+
+template <class Base>
+SGP30FeatureSet<Base>::SGP30FeatureSet()
+{
+  featureSetVersion = 0;
+}
+
+//datasheet says 1-2ms
+template <class Base>
+SGP30ERR SGP30FeatureSet<Base>::getFeatureSetVersion(void)
+{
+  uint16_t words[1];
+  SGP30ERR error = this->_measure(get_feature_set_version, 2, words, 1);
+  if (error == SGP30_SUCCESS)
+    featureSetVersion = words[0]; //publish valid data
+  return error;
+}
+
+template <class Base>
+SGP30ERR SGP30FeatureSet<Base>::startFeatureSetVersion(void)
+{
+  return this->_startCommand(get_feature_set_version, 2);
+}
+
+template <class Base>
+SGP30ERR SGP30FeatureSet<Base>::readFeatureSetVersion(void)
+{
+  uint16_t words[1];
+  SGP30ERR error = this->_read(get_feature_set_version, words, 1);
+  if (error == SGP30_SUCCESS)
+    featureSetVersion = words[0]; //publish valid data
+  return error;
+}
+
+//datasheet says 200-220ms
+template <class Base>
+SGP30ERR SGP30SelfTest<Base>::measureTest(void)
+{
+  uint16_t results[1] = {0};
+  SGP30ERR error = this->_measure(measure_test, 220, results, 1);
+  return _testResult(error, results[0]);
+}
+
+template <class Base>
+SGP30ERR SGP30SelfTest<Base>::startTest(void)
+{
+  return this->_startCommand(measure_test, 220);
+}
+
+template <class Base>
+SGP30ERR SGP30SelfTest<Base>::readTest(void)
+{
+  uint16_t results[1] = {0};
+  SGP30ERR error = this->_read(measure_test, results, 1);
+  return _testResult(error, results[0]);
+}
+
+template <class Base>
+SGP30ERR SGP30SelfTest<Base>::_testResult(SGP30ERR error, uint16_t result)
+{
+  if (error != SGP30_SUCCESS)
+    return error;
+  if (result != 0xD400)
+    return SGP30_SELF_TEST_FAIL; //self test results incorrect
+  return SGP30_SUCCESS;
+}
+
+template <class Base>
+SGP30Baselines<Base>::SGP30Baselines()
+{
+  baselineCO2 = 0;
+  baselineTVOC = 0;
+}
+
+//datasheet says 10ms
+template <class Base>
+SGP30ERR SGP30Baselines<Base>::getBaseline(void)
+{
+  uint16_t words[2];
+  return _publishBaseline(this->_measure(get_baseline, 10, words, 2), words);
+}
+
+template <class Base>
+SGP30ERR SGP30Baselines<Base>::startBaseline(void)
+{
+  return this->_startCommand(get_baseline, 10);
+}
+
+template <class Base>
+SGP30ERR SGP30Baselines<Base>::readBaseline(void)
+{
+  uint16_t words[2];
+  return _publishBaseline(this->_read(get_baseline, words, 2), words);
+}
+
+template <class Base>
+SGP30ERR SGP30Baselines<Base>::setBaseline(uint16_t baselineCO2, uint16_t baselineTVOC)
+{
+  if (this->_pendingCommand != NULL)
+    return SGP30_ERR_BUSY; //would drop the unread result
+  //Sent as baseline TVOC / Checksum then baseline CO2 / Checksum
+  const uint16_t words[2] = {baselineTVOC, baselineCO2};
+  if (!this->_writeWords(set_baseline, words))
+    return SGP30_ERR_I2C_TIMEOUT;
+  return SGP30_SUCCESS;
+}
+
+template <class Base>
+SGP30ERR SGP30Baselines<Base>::_publishBaseline(SGP30ERR error, const uint16_t words[2])
+{
+  if (error != SGP30_SUCCESS)
+    return error;
+  baselineCO2 = words[0];  //publish valid data
+  baselineTVOC = words[1]; //publish valid data
+  return SGP30_SUCCESS;
+}
+
+template <class Base>
+SGP30HumidityCompensation<Base>::SGP30HumidityCompensation()
+{
+  _humidity = 0;
+  _humidityHysteresis = 16;
+  _humiditySet = false;
+}
+
+template <class Base>
+SGP30ERR SGP30HumidityCompensation<Base>::setHumidity(uint16_t humidity)
+{
+  if (this->_pendingCommand != NULL)
+    return SGP30_ERR_BUSY; //would drop the unread result
+  const uint16_t words[1] = {humidity};
+  if (!this->_writeWords(set_humidity, words))
+    return SGP30_ERR_I2C_TIMEOUT;
+  _humidity = humidity;
+  _humiditySet = true;
+  return SGP30_SUCCESS;
+}
+
+//Only updates the sensor when absolute humidity moved past the hysteresis
+template <class Base>
+bool SGP30HumidityCompensation<Base>::setRelativeHumidity(int16_t temperature, uint16_t relativeHumidity)
+{
+  uint16_t humidity = sgp30AbsoluteHumidity(temperature, relativeHumidity);
+  uint16_t change = humidity > _humidity ? humidity - _humidity : _humidity - humidity;
+  if (_humiditySet && change <= _humidityHysteresis)
+    return false;
+  return setHumidity(humidity) == SGP30_SUCCESS;
+}
+
+template <class Base>
+void SGP30HumidityCompensation<Base>::setHumidityHysteresis(uint16_t hysteresis)
+{
+  _humidityHysteresis = hysteresis;
+}
+
+template <class Base>
+void SGP30HumidityCompensation<Base>::generalCallReset(void)
+{
+  Base::generalCallReset();
+  _humiditySet = false;
+}
+
+#endif
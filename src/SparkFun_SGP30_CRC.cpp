@@ -0,0 +1,121 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  CRC8 kernels for the SGP30, see SparkFun_SGP30_CRC.h
+  From: http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
+  Tested with: http://www.sunshine2k.de/coding/javascript/crc/crc_js.html
+*/
+
+#include "SparkFun_SGP30_CRC.h"
+
+//One shift/xor step of the polynomial
+static constexpr uint8_t _sgp30CRCStep(uint8_t crc)
+{
+  return (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+}
+
+//crc pushed through steps shift/xor steps
+static constexpr uint8_t _sgp30CRCSteps(uint8_t crc, uint8_t steps)
+{
+  return steps == 0 ? crc : _sgp30CRCSteps(_sgp30CRCStep(crc), steps - 1);
+}
+
+//Table entries: the CRC remainder of one byte, or of one high nibble
+static constexpr uint8_t _sgp30CRCByteEntry(int index)
+{
+  return _sgp30CRCSteps((uint8_t)index, 8);
+}
+
+static constexpr uint8_t _sgp30CRCNibbleEntry(int index)
+{
+  return _sgp30CRCSteps((uint8_t)(index << 4), 4);
+}
+
+//Spot check against the table from Bastian Molkenthin's calculator
+static_assert(_sgp30CRCByteEntry(0x01) == 0x31 && _sgp30CRCByteEntry(0x10) == 0x43 &&
+                  _sgp30CRCByteEntry(0xFF) == 0xAC,
+              "CRC8 table generator does not match polynomial 0x31");
+
+#define _SGP30_TABLE4(entry, n) entry(n), entry(n + 1), entry(n + 2), entry(n + 3)
+#define _SGP30_TABLE16(entry, n) _SGP30_TABLE4(entry, n), _SGP30_TABLE4(entry, n + 4), \
+                                 _SGP30_TABLE4(entry, n + 8), _SGP30_TABLE4(entry, n + 12)
+#define _SGP30_TABLE64(entry, n) _SGP30_TABLE16(entry, n), _SGP30_TABLE16(entry, n + 16), \
+                                 _SGP30_TABLE16(entry, n + 32), _SGP30_TABLE16(entry, n + 48)
+
+const uint8_t sgp30CRC8NibbleTable[16] PROGMEM = {_SGP30_TABLE16(_sgp30CRCNibbleEntry, 0)};
+
+const uint8_t sgp30CRC8ByteTable[256] PROGMEM = {
+    _SGP30_TABLE64(_sgp30CRCByteEntry, 0), _SGP30_TABLE64(_sgp30CRCByteEntry, 64),
+    _SGP30_TABLE64(_sgp30CRCByteEntry, 128), _SGP30_TABLE64(_sgp30CRCByteEntry, 192)};
+
+//No table, smallest code
+uint8_t sgp30CRC8Bitwise(const uint8_t *data, uint8_t length)
+{
+  uint8_t crc = SGP30_CRC_INIT;
+  while (length--)
+  {
+    crc ^= *data++; // XOR-in the next input byte
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      if ((crc & 0x80) != 0)
+        crc = (uint8_t)((crc << 1) ^ 0x31);
+      else
+        crc <<= 1;
+    }
+  }
+  return crc; //No output reflection
+}
+
+//16 entry table, one lookup per nibble
+uint8_t sgp30CRC8Nibble(const uint8_t *data, uint8_t length)
+{
+  uint8_t crc = SGP30_CRC_INIT;
+  while (length--)
+  {
+    crc ^= *data++;
+    crc = (uint8_t)(crc << 4) ^ pgm_read_byte(&sgp30CRC8NibbleTable[crc >> 4]);
+    crc = (uint8_t)(crc << 4) ^ pgm_read_byte(&sgp30CRC8NibbleTable[crc >> 4]);
+  }
+  return crc;
+}
+
+//256 entry table, one lookup per byte
+uint8_t sgp30CRC8Byte(const uint8_t *data, uint8_t length)
+{
+  uint8_t crc = SGP30_CRC_INIT;
+  while (length--)
+    crc = pgm_read_byte(&sgp30CRC8ByteTable[crc ^ *data++]);
+  return crc;
+}
+
+//CRC8 of length bytes with the selected kernel
+uint8_t sgp30CRC8(const uint8_t *data, uint8_t length)
+{
+#if SGP30_CRC_KERNEL == SGP30_CRC_BYTE_TABLE
+  return sgp30CRC8Byte(data, length);
+#elif SGP30_CRC_KERNEL == SGP30_CRC_NIBBLE
+  return sgp30CRC8Nibble(data, length);
+#else
+  return sgp30CRC8Bitwise(data, length);
+#endif
+}
+
+//CRC8 of a 16 bit word sent MSB first
+uint8_t sgp30CRC8Word(uint16_t word)
+{
+  uint8_t bytes[2] = {(uint8_t)(word >> 8), (uint8_t)word};
+  return sgp30CRC8(bytes, 2);
+}
+
+//Checks every (MSB, LSB, CRC) triplet of a response in one pass
+bool sgp30VerifyWords(const uint8_t *frame, uint8_t words)
+{
+  while (words--)
+  {
+    if (sgp30CRC8(frame, 2) != frame[2])
+      return false;
+    frame += 3;
+  }
+  return true;
+}
@@ -0,0 +1,60 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  CRC8 for the SGP30, x^8+x^5+x^4+1 = 0x31, initial value 0xFF, no reflection.
+  Three kernels trade code size for speed:
+    SGP30_CRC_BITWISE     no table, 8 shift/xor steps per byte (default)
+    SGP30_CRC_NIBBLE      16 byte table, 2 lookups per byte
+    SGP30_CRC_BYTE_TABLE  256 byte table, 1 lookup per byte
+  The driver uses the one selected by SGP30_CRC_KERNEL (SGP30_LOOKUP_TABLE
+  selects SGP30_CRC_BYTE_TABLE). Tables are generated at compile time and
+  shared by every SGP30 object; on AVR they live in flash (PROGMEM).
+*/
+
+#ifndef SparkFun_SGP30_CRC_h
+#define SparkFun_SGP30_CRC_h
+
+#include "Arduino.h"
+
+#define SGP30_CRC_BITWISE 0
+#define SGP30_CRC_NIBBLE 1
+#define SGP30_CRC_BYTE_TABLE 2
+
+#ifndef SGP30_CRC_KERNEL
+#ifdef SGP30_LOOKUP_TABLE
+#define SGP30_CRC_KERNEL SGP30_CRC_BYTE_TABLE
+#else
+#define SGP30_CRC_KERNEL SGP30_CRC_BITWISE
+#endif
+#endif
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_byte
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#endif
+
+#define SGP30_CRC_INIT 0xFF
+
+//Tables, filled in at compile time
+extern const uint8_t sgp30CRC8NibbleTable[16] PROGMEM;
+extern const uint8_t sgp30CRC8ByteTable[256] PROGMEM;
+
+//CRC8 of length bytes with each kernel
+uint8_t sgp30CRC8Bitwise(const uint8_t *data, uint8_t length);
+uint8_t sgp30CRC8Nibble(const uint8_t *data, uint8_t length);
+uint8_t sgp30CRC8Byte(const uint8_t *data, uint8_t length);
+
+//CRC8 of length bytes with the selected kernel
+uint8_t sgp30CRC8(const uint8_t *data, uint8_t length);
+
+//CRC8 of a 16 bit word sent MSB first, as used on the wire
+uint8_t sgp30CRC8Word(uint16_t word);
+
+//Checks a whole response of words * (MSB, LSB, CRC) in one pass
+//Returns true if every checksum matches
+bool sgp30VerifyWords(const uint8_t *frame, uint8_t words);
+
+#endif
@@ -0,0 +1,324 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+  The commands and frame handling were moved here from
+  SparkFun_SGP30_Arduino_Library.cpp, by Ciara Jekel @ SparkFun
+  Electronics, June 18th, 2018
+
+  Command layer shared by SGP30 and BasicSGP30, see SparkFun_SGP30_Core.h
+*/
+
+#include "SparkFun_SGP30_Core.h"
+
+SGP30Core::SGP30Core()
+{
+  CO2 = 0;
+  TVOC = 0;
+  _transport = &_wire;
+  _pendingCommand = NULL;
+  _commandStart = 0;
+  _commandDelay = 0;
+  _commandReady = false;
+#ifdef SGP30_ENABLE_STATS
+  resetStats();
+  _statsCommand = SGP30_CMD_GET_SERIAL_ID;
+  _statsStart = 0;
+#endif
+}
+
+//Start I2C communication using specified port
+//Returns true if successful or false if no sensor detected
+bool SGP30Core::begin(TwoWire &wirePort)
+{
+  _wire.setPort(wirePort); //Grab which port the user wants us to use
+  return begin(_wire);
+}
+
+//Start communication over any transport
+//Returns true if successful or false if no sensor detected
+bool SGP30Core::begin(SGP30Transport &transport)
+{
+  _transport = &transport;
+  _pendingCommand = NULL;
+  uint16_t version[1];
+  return _measure(get_feature_set_version, 2, version, 1) == SGP30_SUCCESS;
+}
+
+//Initilizes sensor for air quality readings
+//measureAirQuality should be called in 1 second intervals after this function
+//Returns SGP30_ERR_I2C_TIMEOUT if the sensor did not acknowledge the command
+SGP30ERR SGP30Core::initAirQuality(void)
+{
+  if (_pendingCommand != NULL)
+    return SGP30_ERR_BUSY; //would drop the unread result
+  if (!_writeFrame(init_air_quality, NULL, 0)) //command to initialize air quality readings
+    return SGP30_ERR_I2C_TIMEOUT;
+  return SGP30_SUCCESS;
+}
+
+//Measure air quality
+//Returns SGP30_SUCCESS if successful or other error code if unsuccessful
+SGP30ERR SGP30Core::measureAirQuality(void)
+{
+  uint16_t words[2];
+  SGP30ERR error = _measure(measure_air_quality, 12, words, 2);
+  if (error != SGP30_SUCCESS)
+    return error;
+  CO2 = words[0];  //publish valid data
+  TVOC = words[1]; //publish valid data
+  return SGP30_SUCCESS;
+}
+
+//Starts an air quality measurement without waiting for it
+//datasheet says 10-12ms until the result can be read with readAirQuality()
+SGP30ERR SGP30Core::startAirQuality(void)
+{
+  return _startCommand(measure_air_quality, 12);
+}
+
+//Reads the result of startAirQuality()
+//Returns SGP30_SUCCESS if successful or other error code if unsuccessful
+SGP30ERR SGP30Core::readAirQuality(void)
+{
+  uint16_t words[2];
+  SGP30ERR error = _read(measure_air_quality, words, 2);
+  if (error != SGP30_SUCCESS)
+    return error;
+  CO2 = words[0];  //publish valid data
+  TVOC = words[1]; //publish valid data
+  return SGP30_SUCCESS;
+}
+
+//Soft reset - not device specific
+//will reset all devices that support general call mode
+void SGP30Core::generalCallReset(void)
+{
+  const uint8_t reset = 0x06;         //reset command
+  _transport->write(0x00, &reset, 1); //general call address
+  _pendingCommand = NULL;             //any command in progress is lost
+}
+
+//Returns true once the pending command has finished and its result can be read
+//The command delay is counted in whole milliseconds so one extra tick is required
+//to be sure the full delay has passed
+bool SGP30Core::isReady(void)
+{
+  if (_pendingCommand == NULL)
+    return false;
+  if (!_commandReady && (uint32_t)(millis() - _commandStart) > _commandDelay)
+    _commandReady = true; //latch so millis() rollover can't undo it
+  return _commandReady;
+}
+
+//Returns true while a started command has not been read yet
+bool SGP30Core::isBusy(void)
+{
+  return _pendingCommand != NULL;
+}
+
+//Returns true while command is the one started and not read yet
+//Compared by value: each translation unit has its own copy of the constants
+bool SGP30Core::isPending(const uint8_t command[2])
+{
+  return _pendingCommand != NULL && _pendingCommand[0] == command[0] && _pendingCommand[1] == command[1];
+}
+
+//Forgets a started command, the sensor discards its result with the next command
+void SGP30Core::cancel(void)
+{
+  _pendingCommand = NULL;
+}
+
+//Milliseconds left until the pending command is ready, 0 if ready or idle
+unsigned long SGP30Core::msUntilReady(void)
+{
+  if (_pendingCommand == NULL || isReady())
+    return 0;
+  return (unsigned long)_commandDelay + 1 - (uint32_t)(millis() - _commandStart);
+}
+
+#ifdef SGP30_ENABLE_STATS
+//Copies the counters, and clears them if reset is true
+void SGP30Core::snapshotStats(SGP30Stats &snapshot, bool reset)
+{
+  snapshot = _stats;
+  if (reset)
+    resetStats();
+}
+
+void SGP30Core::resetStats(void)
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+//Index of a command in SGP30Stats::commands, the second byte tells them apart
+static uint8_t _statsIndex(const uint8_t command[2])
+{
+  switch (command[1])
+  {
+  case 0x03:
+    return SGP30_CMD_INIT_AIR_QUALITY;
+  case 0x08:
+    return SGP30_CMD_MEASURE_AIR_QUALITY;
+  case 0x15:
+    return SGP30_CMD_GET_BASELINE;
+  case 0x1E:
+    return SGP30_CMD_SET_BASELINE;
+  case 0x61:
+    return SGP30_CMD_SET_HUMIDITY;
+  case 0x32:
+    return SGP30_CMD_MEASURE_TEST;
+  case 0x2F:
+    return SGP30_CMD_GET_FEATURE_SET_VERSION;
+  case 0x82:
+    return SGP30_CMD_GET_SERIAL_ID;
+  case 0xB3:
+    return SGP30_CMD_GET_TVOC_INCEPTIVE_BASELINE;
+  case 0x77:
+    return SGP30_CMD_SET_TVOC_BASELINE;
+  default:
+    return SGP30_CMD_MEASURE_RAW_SIGNALS;
+  }
+}
+
+//Adds one latency sample to a command
+void SGP30Core::_statsLatency(SGP30CommandStats &command, uint32_t latency)
+{
+  if (command.completed == 0 || latency < command.latencyMin)
+    command.latencyMin = latency;
+  if (latency > command.latencyMax)
+    command.latencyMax = latency;
+  command.latencySum += latency;
+  command.completed++;
+}
+#endif
+
+//Sends a command and records when its result will be ready
+//Refused while another command has not been read, even a finished one: the
+//sensor would discard its result and its owner would wait for it forever
+//A command the sensor did not acknowledge leaves nothing pending
+SGP30ERR SGP30Core::_startCommand(const uint8_t command[2], uint8_t commandDelay)
+{
+  if (_pendingCommand != NULL)
+    return SGP30_ERR_BUSY;
+  if (!_writeFrame(command, NULL, 0))
+  {
+    _pendingCommand = NULL;
+    return SGP30_ERR_I2C_TIMEOUT;
+  }
+  _pendingCommand = command;
+  _commandStart = millis();
+  _commandDelay = commandDelay;
+  _commandReady = false;
+  return SGP30_SUCCESS;
+}
+
+//Checks that command is the pending command and that it has finished
+SGP30ERR SGP30Core::_checkCommand(const uint8_t command[2])
+{
+  if (!isPending(command) || !isReady())
+    return SGP30_ERR_NOT_READY;
+  return SGP30_SUCCESS;
+}
+
+//Hang out while the pending command is processed
+void SGP30Core::_waitForCommand(void)
+{
+  delay(_commandDelay);
+  _commandReady = true;
+}
+
+//Whole command in one call, for commands without side effects
+SGP30ERR SGP30Core::_measure(const uint8_t command[2], uint8_t commandDelay, uint16_t *words, uint8_t count)
+{
+  SGP30ERR error = _startCommand(command, commandDelay);
+  if (error != SGP30_SUCCESS)
+    return error;
+  _waitForCommand();
+  _pendingCommand = NULL;
+  return _readFrame(words, count);
+}
+
+//Collects the result of a command started earlier
+SGP30ERR SGP30Core::_read(const uint8_t command[2], uint16_t *words, uint8_t count)
+{
+  SGP30ERR error = _checkCommand(command);
+  if (error != SGP30_SUCCESS)
+    return error;
+  _pendingCommand = NULL;
+  return _readFrame(words, count);
+}
+
+//Reads count words in one transfer and verifies every checksum
+//words is only written once the whole frame has checked out
+SGP30ERR SGP30Core::_readFrame(uint16_t *words, uint8_t count)
+{
+  uint8_t frame[3 * SGP30_MAX_WORDS];
+  uint8_t length = 3 * count;
+#ifdef SGP30_ENABLE_STATS
+  SGP30CommandStats &stats = _stats.commands[_statsCommand];
+#endif
+  if (!_transport->read(_SGP30Address, frame, length))
+  {
+#ifdef SGP30_ENABLE_STATS
+    stats.timeouts++;
+#endif
+    return SGP30_ERR_I2C_TIMEOUT; //Error out
+  }
+#ifdef SGP30_ENABLE_STATS
+  _stats.bytesReceived += length;
+#endif
+  if (!sgp30VerifyWords(frame, count))
+  {
+#ifdef SGP30_ENABLE_STATS
+    stats.badCRC++;
+#endif
+    return SGP30_ERR_BAD_CRC; //checksum failed
+  }
+  for (uint8_t i = 0; i < count; i++)
+    words[i] = ((uint16_t)frame[3 * i] << 8) | frame[3 * i + 1];
+#ifdef SGP30_ENABLE_STATS
+  _statsLatency(stats, micros() - _statsStart);
+#endif
+  return SGP30_SUCCESS;
+}
+
+//Sends command followed by count words, each as MSB / LSB / Checksum, in one transfer
+//Returns false if the sensor did not acknowledge it
+bool SGP30Core::_writeFrame(const uint8_t command[2], const uint16_t *words, uint8_t count)
+{
+  uint8_t frame[2 + 3 * SGP30_MAX_WORDS];
+  uint8_t length = 2;
+  frame[0] = command[0];
+  frame[1] = command[1];
+  for (uint8_t i = 0; i < count; i++)
+  {
+    frame[length++] = words[i] >> 8;
+    frame[length++] = words[i];
+    frame[length] = sgp30CRC8(&frame[length - 2], 2);
+    length++;
+  }
+#ifdef SGP30_ENABLE_STATS
+  uint8_t index = _statsIndex(command);
+  SGP30CommandStats &stats = _stats.commands[index];
+  uint32_t start = micros();
+  stats.calls++;
+  if (!_transport->write(_SGP30Address, frame, length))
+  {
+    stats.timeouts++;
+    return false;
+  }
+  _stats.bytesSent += length;
+  //Commands with parameters, and init, have no response: done once written
+  if (count > 0 || index == SGP30_CMD_INIT_AIR_QUALITY)
+    _statsLatency(stats, micros() - start);
+  else
+  {
+    _statsCommand = index;
+    _statsStart = start;
+  }
+  return true;
+#else
+  return _transport->write(_SGP30Address, frame, length);
+#endif
+}
@@ -0,0 +1,172 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+  The commands and frame handling were moved here from
+  SparkFun_SGP30_Arduino_Library.cpp, by Ciara Jekel @ SparkFun
+  Electronics, June 18th, 2018
+
+  Command layer shared by SGP30 and the configurable BasicSGP30
+  (SparkFun_SGP30_Basic.h): the transport, the split-phase command state,
+  checksummed frame I/O, the instrumentation counters and the air quality
+  measurement every configuration has.
+*/
+
+#ifndef SparkFun_SGP30_Core_h
+#define SparkFun_SGP30_Core_h
+
+#include "Arduino.h"
+#include <Wire.h>
+#include "SparkFun_SGP30_CRC.h"
+#include "SparkFun_SGP30_Transport.h"
+#include "SparkFun_SGP30_Stats.h"
+
+typedef enum
+{
+  SGP30_SUCCESS = 0,
+  SGP30_ERR_BAD_CRC,
+  SGP30_ERR_I2C_TIMEOUT,
+  SGP30_SELF_TEST_FAIL,
+  SGP30_ERR_BUSY,
+  SGP30_ERR_NOT_READY,
+  SGP30_ERR_UNSUPPORTED
+} SGP30ERR;
+
+const uint8_t init_air_quality[2] = {0x20, 0x03};
+const uint8_t measure_air_quality[2] = {0x20, 0x08};
+const uint8_t get_baseline[2] = {0x20, 0x15};
+const uint8_t set_baseline[2] = {0x20, 0x1E};
+const uint8_t set_humidity[2] = {0x20, 0x61};
+const uint8_t measure_test[2] = {0x20, 0x32};
+const uint8_t get_feature_set_version[2] = {0x20, 0x2F};
+const uint8_t get_serial_id[2] = {0x36, 0x82};
+const uint8_t measure_raw_signals[2] = {0x20, 0x50};
+const uint8_t get_tvoc_inceptive_baseline[2] = {0x20, 0xB3};
+const uint8_t set_tvoc_baseline[2] = {0x20, 0x77};
+
+//Longest response (serial ID) and parameter list (set_baseline) in words
+#define SGP30_MAX_WORDS 3
+
+class SGP30Core
+{
+public:
+  uint16_t CO2;
+  uint16_t TVOC;
+
+  SGP30Core();
+
+  //Start communication, returns true if the sensor answers
+  //Only checks for the sensor: reads the feature set version and drops it
+  bool begin(TwoWire &wirePort = Wire);
+  bool begin(SGP30Transport &transport);
+
+  //Initializes sensor for air quality readings
+  //Returns SGP30_ERR_I2C_TIMEOUT if the command was not acknowledged, or
+  //SGP30_ERR_BUSY while a started command has not been read
+  SGP30ERR initAirQuality(void);
+
+  //Measure air quality, call every second after initAirQuality()
+  //CO2 returned in ppm, TVOC returned in ppb
+  SGP30ERR measureAirQuality(void);
+
+  //Non-blocking version, see SGP30
+  SGP30ERR startAirQuality(void);
+  SGP30ERR readAirQuality(void);
+
+  //Soft reset - not device specific
+  //will reset all devices that support general call mode
+  void generalCallReset(void);
+
+  //Returns true once the pending command has finished and its result can be read
+  bool isReady(void);
+
+  //Returns true while a started command has not been read yet
+  //Every other command gets SGP30_ERR_BUSY until it is, so that its
+  //result is never thrown away behind its owner's back
+  bool isBusy(void);
+
+  //Returns true while command (e.g. measure_air_quality) is the one started
+  //and not read yet, false once it was read, cancelled or lost in a reset
+  bool isPending(const uint8_t command[2]);
+
+  //Forgets a started command that will not be read, its result is lost
+  void cancel(void);
+
+  //Milliseconds left until the pending command is ready, 0 if ready or idle
+  unsigned long msUntilReady(void);
+
+#ifdef SGP30_ENABLE_STATS
+  //Instrumentation counters (see SparkFun_SGP30_Stats.h)
+  const SGP30Stats &stats(void) { return _stats; }
+
+  //Copies the counters, and clears them if reset is true, for telemetry
+  void snapshotStats(SGP30Stats &snapshot, bool reset = false);
+  void resetStats(void);
+#endif
+
+protected:
+  //Every transaction goes through this
+  SGP30Transport *_transport;
+
+  //Adapter used by begin(TwoWire&)
+  SGP30TwoWireTransport _wire;
+
+  //SGP30's I2C address
+  static const uint8_t _SGP30Address = 0x58;
+
+  //Split-phase command state
+  //_pendingCommand points at the command constant sent by start*(), NULL when idle
+  const uint8_t *_pendingCommand;
+  unsigned long _commandStart; //millis() when the command was sent
+  uint8_t _commandDelay;       //time the sensor needs to process the command (ms)
+  bool _commandReady;          //latched once the command delay has passed
+
+#ifdef SGP30_ENABLE_STATS
+  SGP30Stats _stats;
+  uint8_t _statsCommand;   //SGP30COMMAND whose response is expected next
+  uint32_t _statsStart;    //micros() when it was sent
+
+  //Adds one latency sample to a command
+  static void _statsLatency(SGP30CommandStats &command, uint32_t latency);
+#endif
+
+  //Sends a command and records its deadline, nothing is pending if it fails
+  //Refused with SGP30_ERR_BUSY while another command has not been read
+  SGP30ERR _startCommand(const uint8_t command[2], uint8_t commandDelay);
+
+  //Checks that command was started and is ready to be read
+  SGP30ERR _checkCommand(const uint8_t command[2]);
+
+  //Blocks for the full delay of the pending command
+  void _waitForCommand(void);
+
+  //Whole command in one call: start, wait, then read count words
+  SGP30ERR _measure(const uint8_t command[2], uint8_t commandDelay, uint16_t *words, uint8_t count);
+
+  //Reads count words once command, started earlier, is ready
+  SGP30ERR _read(const uint8_t command[2], uint16_t *words, uint8_t count);
+
+  //Reads a response of N words, each sent as MSB / LSB / Checksum
+  //The frame is read into a buffer and every checksum verified before
+  //anything is stored, so words is either fully updated or left untouched
+  template <uint8_t N>
+  SGP30ERR _readWords(uint16_t (&words)[N])
+  {
+    static_assert(N > 0 && N <= SGP30_MAX_WORDS, "SGP30 responses are 1 to 3 words");
+    return _readFrame(words, N);
+  }
+
+  //Sends a command followed by N parameter words, each with its checksum
+  template <uint8_t N>
+  bool _writeWords(const uint8_t command[2], const uint16_t (&words)[N])
+  {
+    static_assert(N > 0 && N <= SGP30_MAX_WORDS, "SGP30 parameters are 1 to 3 words");
+    return _writeFrame(command, words, N);
+  }
+
+  //Shared by every _readWords<N>/_writeWords<N> so the code exists once
+  //_writeFrame returns false if the sensor did not acknowledge the frame
+  SGP30ERR _readFrame(uint16_t *words, uint8_t count);
+  bool _writeFrame(const uint8_t command[2], const uint16_t *words, uint8_t count);
+};
+
+#endif
@@ -0,0 +1,55 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  EEPROM storage for SGP30BaselineManager.
+  Kept out of the main header so sketches that don't use it don't need EEPROM.h.
+  Each record takes 20 bytes, a 200 byte region rotates through 10 slots.
+  On ESP8266/ESP32 call EEPROM.begin(size) before using it.
+*/
+
+#ifndef SparkFun_SGP30_EEPROM_h
+#define SparkFun_SGP30_EEPROM_h
+
+#include <EEPROM.h>
+#include "SparkFun_SGP30_Baseline.h"
+
+class SGP30EEPROMStorage : public SGP30BaselineStorage
+{
+public:
+  //Uses length bytes of EEPROM starting at start
+  SGP30EEPROMStorage(uint16_t start, uint16_t length)
+  {
+    _start = start;
+    _length = length;
+  }
+
+  uint16_t size(void) { return _length; }
+
+  void read(uint16_t address, uint8_t *data, uint8_t length)
+  {
+    for (uint8_t i = 0; i < length; i++)
+      data[i] = EEPROM.read(_start + address + i);
+  }
+
+  //Only bytes that differ are written, to save EEPROM wear
+  bool write(uint16_t address, const uint8_t *data, uint8_t length)
+  {
+    for (uint8_t i = 0; i < length; i++)
+    {
+      if (EEPROM.read(_start + address + i) != data[i])
+        EEPROM.write(_start + address + i, data[i]);
+    }
+#if defined(ESP8266) || defined(ESP32)
+    return EEPROM.commit();
+#else
+    return true;
+#endif
+  }
+
+private:
+  uint16_t _start;
+  uint16_t _length;
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Integer raw signal to concentration conversion, see SparkFun_SGP30_Gas.h
+*/
+
+#include "SparkFun_SGP30_Gas.h"
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_word
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#endif
+
+//Signal differences beyond this are 0 or saturated whatever the reference (2^46)
+#define SGP30_GAS_MAX_DIFFERENCE 16384
+
+//2^(i/16) in Q15, i = 0..15
+static const uint16_t _exp2Table[16] PROGMEM = {
+    32768, 34219, 35734, 37316, 38968, 40693, 42495, 44376,
+    46341, 48393, 50535, 52773, 55109, 57549, 60097, 62757};
+
+uint32_t sgp30GasConcentration(uint16_t signal, uint16_t reference, uint16_t referenceConcentration)
+{
+  int32_t difference = (int32_t)reference - signal;
+  if (difference > SGP30_GAS_MAX_DIFFERENCE)
+    difference = SGP30_GAS_MAX_DIFFERENCE;
+  if (difference < -SGP30_GAS_MAX_DIFFERENCE)
+    difference = -SGP30_GAS_MAX_DIFFERENCE;
+
+  //exp(d / 512) = 2^(d * log2(e) / 512), exponent in Q16
+  //log2(e) / 512 * 2^16 = 184.66497, split to keep the products in 32 bits
+  int32_t exponent = difference * 184 + ((difference * 43579L) >> 16);
+  int8_t whole = (int8_t)(exponent >> 16); //floor, so the fraction is positive
+  uint16_t fraction = (uint16_t)exponent;
+
+  //2^r for r = fraction mod 1/16, r*ln2 < 0.044 so 1 + x + x^2/2 is enough
+  uint32_t x = ((uint32_t)(fraction & 0x0FFF) * 45426UL) >> 16; //ln2 in Q16
+  uint32_t power = 65536UL + x + ((x * x) >> 17);
+  //Mantissa in Q15, 32768 to 65535
+  uint32_t mantissa = ((uint32_t)pgm_read_word(&_exp2Table[fraction >> 12]) * (power >> 1)) >> 15;
+
+  uint32_t value = referenceConcentration * mantissa; //Q15
+  int8_t shift = whole - 15;
+  if (shift >= 0)
+  {
+    if (shift >= 32 || (shift > 0 && (value >> (32 - shift)) != 0))
+      return 0xFFFFFFFF;
+    return value << shift;
+  }
+  shift = -shift;
+  if (shift > 32)
+    return 0;
+  return ((value >> (shift - 1)) + 1) >> 1; //rounded
+}
+
+SGP30GasConverter::SGP30GasConverter(uint16_t referenceH2, uint16_t referenceEthanol)
+{
+  this->referenceH2 = referenceH2;
+  this->referenceEthanol = referenceEthanol;
+  _sumH2 = 0;
+  _sumEthanol = 0;
+  _samples = 0;
+  _count = 0;
+}
+
+uint32_t SGP30GasConverter::H2(uint16_t signal)
+{
+  return sgp30GasConcentration(signal, referenceH2, SGP30_H2_REFERENCE_PPB);
+}
+
+uint32_t SGP30GasConverter::ethanol(uint16_t signal)
+{
+  return sgp30GasConcentration(signal, referenceEthanol, SGP30_ETHANOL_REFERENCE_PPB);
+}
+
+//Starts averaging clean air samples, the references are kept until it completes
+void SGP30GasConverter::startCalibration(uint16_t samples)
+{
+  _sumH2 = 0;
+  _sumEthanol = 0;
+  _samples = samples ? samples : 1;
+  _count = 0;
+}
+
+bool SGP30GasConverter::calibrate(uint16_t H2, uint16_t ethanol)
+{
+  if (!calibrating())
+    return false;
+  _sumH2 += H2;
+  _sumEthanol += ethanol;
+  if (++_count < _samples)
+    return false;
+  referenceH2 = (_sumH2 + _samples / 2) / _samples;
+  referenceEthanol = (_sumEthanol + _samples / 2) / _samples;
+  return true;
+}
@@ -0,0 +1,69 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Integer conversion of the raw H2 and ethanol signals to concentration,
+  without exp() or floating point.
+
+  The datasheet gives c = c_ref * exp((s_ref - s_out) / 512), where s_out
+  is the raw signal, s_ref the signal in clean air and c_ref the clean air
+  concentration (0.5 ppm H2, 0.4 ppm ethanol). The exponent is rewritten in
+  base 2 as n + i/16 + r: 2^n is a shift, 2^(i/16) comes from a 16 word
+  table in flash and 2^r (r < 1/16) from a quadratic. Compared to double
+  precision exp() the result is within 0.01% + 1 count, up to the largest
+  value that fits in 32 bits (results above saturate at 0xFFFFFFFF).
+
+  s_ref differs from sensor to sensor. SGP30GasConverter starts from
+  typical values and can calibrate them from samples taken in clean air.
+*/
+
+#ifndef SparkFun_SGP30_Gas_h
+#define SparkFun_SGP30_Gas_h
+
+#include "Arduino.h"
+
+//Clean air concentrations from the datasheet, in ppb
+#define SGP30_H2_REFERENCE_PPB 500
+#define SGP30_ETHANOL_REFERENCE_PPB 400
+
+//Typical clean air signals, calibrate for accurate concentrations
+#define SGP30_H2_REFERENCE_SIGNAL 13600
+#define SGP30_ETHANOL_REFERENCE_SIGNAL 18200
+
+//Concentration for a raw signal, in the unit of referenceConcentration
+//reference is the raw signal at referenceConcentration (s_ref)
+//Saturates at 0xFFFFFFFF
+uint32_t sgp30GasConcentration(uint16_t signal, uint16_t reference, uint16_t referenceConcentration);
+
+class SGP30GasConverter
+{
+public:
+  //Raw signals in clean air (s_ref)
+  uint16_t referenceH2;
+  uint16_t referenceEthanol;
+
+  SGP30GasConverter(uint16_t referenceH2 = SGP30_H2_REFERENCE_SIGNAL,
+                    uint16_t referenceEthanol = SGP30_ETHANOL_REFERENCE_SIGNAL);
+
+  //Concentrations in ppb for raw signals from measureRawSignals()
+  uint32_t H2(uint16_t signal);
+  uint32_t ethanol(uint16_t signal);
+
+  //Averages the next samples raw signals into new references
+  //Only feed it readings taken in clean air
+  void startCalibration(uint16_t samples = 60);
+
+  //Adds a clean air sample, returns true when the references have been updated
+  bool calibrate(uint16_t H2, uint16_t ethanol);
+
+  //True until startCalibration()'s samples have been fed in
+  bool calibrating(void) { return _count < _samples; }
+
+private:
+  uint32_t _sumH2;
+  uint32_t _sumEthanol;
+  uint16_t _samples;
+  uint16_t _count;
+};
+
+#endif
@@ -0,0 +1,257 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Health monitoring for a running SGP30, see SparkFun_SGP30_Health.h
+*/
+
+#include "SparkFun_SGP30_Health.h"
+
+SGP30HealthMonitor::SGP30HealthMonitor()
+{
+  referenceH2 = 0;
+  referenceEthanol = 0;
+  _sensor = NULL;
+  _step = _IDLE;
+  tests = 0;
+  testFailures = 0;
+  lastTest = SGP30_ERR_NOT_READY;
+  readings = 0;
+  crcErrors = 0;
+  timeouts = 0;
+  _windowReadings = 0;
+  _windowErrors = 0;
+  _sameAirQuality = 0;
+  _sameRawSignals = 0;
+  _rawReadings = 0;
+}
+
+//Monitors sensor, counters start over
+void SGP30HealthMonitor::begin(SGP30 &sensor)
+{
+  _sensor = &sensor;
+  _step = _IDLE;
+  tests = 0;
+  testFailures = 0;
+  lastTest = SGP30_ERR_NOT_READY;
+  readings = 0;
+  crcErrors = 0;
+  timeouts = 0;
+  _windowReadings = 0;
+  _windowErrors = 0;
+  _sameAirQuality = 0;
+  _sameRawSignals = 0;
+  _lastCO2 = 0;
+  _lastTVOC = 0;
+  _rawReadings = 0;
+  _referenceSumH2 = 0;
+  _referenceSumEthanol = 0;
+}
+
+//Asks for a self test, update() runs it
+void SGP30HealthMonitor::startTest(void)
+{
+  if (_sensor != NULL && _step == _IDLE)
+    _step = _SAVE_BASELINE;
+}
+
+//Runs the next step of a self test, never waits for the sensor
+SGP30ERR SGP30HealthMonitor::update(void)
+{
+  SGP30ERR error;
+  switch (_step)
+  {
+  case _SAVE_BASELINE:
+    error = _sensor->startBaseline();
+    if (error == SGP30_ERR_BUSY)
+      return SGP30_ERR_NOT_READY; //a measurement is in progress, try again on the next call
+    if (error != SGP30_SUCCESS)
+      break; //no test without the baseline to restore afterwards
+    _step = _READ_BASELINE;
+    return SGP30_ERR_NOT_READY;
+
+  case _READ_BASELINE:
+    if (!_sensor->isPending(get_baseline))
+    {
+      _step = _SAVE_BASELINE; //dropped by a reset or cancel(), ask again
+      return SGP30_ERR_NOT_READY;
+    }
+    if (!_sensor->isReady())
+      return SGP30_ERR_NOT_READY;
+    error = _sensor->readBaseline();
+    if (error != SGP30_SUCCESS)
+      break;
+    _savedCO2 = _sensor->baselineCO2;
+    _savedTVOC = _sensor->baselineTVOC;
+    _step = _START_TEST;
+    //fall through
+
+  case _START_TEST:
+    error = _sensor->startTest();
+    if (error == SGP30_ERR_BUSY)
+      return SGP30_ERR_NOT_READY;
+    if (error != SGP30_SUCCESS)
+      break; //not started, the sensor is still measuring
+    _step = _TEST;
+    return SGP30_ERR_NOT_READY;
+
+  case _TEST:
+    if (!_sensor->isPending(measure_test))
+    {
+      _step = _START_TEST; //dropped before it was read, run it again
+      return SGP30_ERR_NOT_READY;
+    }
+    if (!_sensor->isReady())
+      return SGP30_ERR_NOT_READY;
+    error = _sensor->readTest();
+    tests++;
+    if (error == SGP30_SELF_TEST_FAIL)
+      testFailures++;
+    //The test ended air quality mode, bring it back with the baseline from before
+    _sensor->initAirQuality();
+    delay(10); //init_air_quality takes up to 10ms
+    _sensor->setBaseline(_savedCO2, _savedTVOC);
+    delay(10); //and so does set_baseline
+    _sameAirQuality = 0; //400 ppm / 0 ppb for a while, not stuck
+    break;
+
+  default:
+    return SGP30_ERR_NOT_READY;
+  }
+  _step = _IDLE;
+  lastTest = error;
+  return error;
+}
+
+//Counts a reading and whether it failed on the bus
+void SGP30HealthMonitor::_count(SGP30ERR error)
+{
+  bool failed = error == SGP30_ERR_BAD_CRC || error == SGP30_ERR_I2C_TIMEOUT;
+  readings++;
+  if (error == SGP30_ERR_BAD_CRC)
+    crcErrors++;
+  else if (error == SGP30_ERR_I2C_TIMEOUT)
+    timeouts++;
+  //Older readings weigh less and less
+  if (_windowReadings == 256)
+  {
+    _windowReadings /= 2;
+    _windowErrors /= 2;
+  }
+  _windowReadings++;
+  if (failed)
+    _windowErrors++;
+}
+
+//Pass the result of every air quality reading
+void SGP30HealthMonitor::recordAirQuality(SGP30ERR error)
+{
+  if (_sensor == NULL || error == SGP30_ERR_NOT_READY || error == SGP30_ERR_BUSY)
+    return; //nothing was read
+  _count(error);
+  if (error != SGP30_SUCCESS)
+    return;
+  uint16_t CO2 = _sensor->CO2;
+  uint16_t TVOC = _sensor->TVOC;
+  //The sensor sits at 400 ppm / 0 ppb in clean air and while warming up
+  if (CO2 == _lastCO2 && TVOC == _lastTVOC && (CO2 != 400 || TVOC != 0))
+  {
+    if (_sameAirQuality < SGP30_STUCK_AIR_QUALITY)
+      _sameAirQuality++;
+  }
+  else
+    _sameAirQuality = 0;
+  _lastCO2 = CO2;
+  _lastTVOC = TVOC;
+}
+
+//Pass the result of every raw signal reading
+void SGP30HealthMonitor::recordRawSignals(SGP30ERR error)
+{
+  if (_sensor == NULL || error == SGP30_ERR_NOT_READY || error == SGP30_ERR_BUSY)
+    return;
+  _count(error);
+  if (error != SGP30_SUCCESS)
+    return;
+  uint16_t H2 = _sensor->H2;
+  uint16_t ethanol = _sensor->ethanol;
+
+  //Raw signals are noisy, a sensor repeating them exactly has stopped
+  if (_rawReadings > 0 && H2 == _lastH2 && ethanol == _lastEthanol)
+  {
+    if (_sameRawSignals < SGP30_STUCK_RAW_SIGNALS)
+      _sameRawSignals++;
+  }
+  else
+    _sameRawSignals = 0;
+  _lastH2 = H2;
+  _lastEthanol = ethanol;
+
+  if (_rawReadings == 0)
+  {
+    _averageH2 = (int32_t)H2 << 8;
+    _averageEthanol = (int32_t)ethanol << 8;
+  }
+  else
+  {
+    _averageH2 += (((int32_t)H2 << 8) - _averageH2) / 64;
+    _averageEthanol += (((int32_t)ethanol << 8) - _averageEthanol) / 64;
+  }
+
+  //Without a reference, the first readings become it
+  if (referenceH2 == 0 || referenceEthanol == 0)
+  {
+    _referenceSumH2 += H2;
+    _referenceSumEthanol += ethanol;
+    if (_rawReadings + 1 == SGP30_HEALTH_REFERENCE_SAMPLES)
+    {
+      referenceH2 = (_referenceSumH2 + SGP30_HEALTH_REFERENCE_SAMPLES / 2) / SGP30_HEALTH_REFERENCE_SAMPLES;
+      referenceEthanol = (_referenceSumEthanol + SGP30_HEALTH_REFERENCE_SAMPLES / 2) / SGP30_HEALTH_REFERENCE_SAMPLES;
+    }
+  }
+  if (_rawReadings < 0xFFFF)
+    _rawReadings++;
+}
+
+//Bus errors per thousand recent readings
+uint16_t SGP30HealthMonitor::errorRate(void)
+{
+  if (_windowReadings == 0)
+    return 0;
+  return (uint16_t)(((uint32_t)_windowErrors * 1000 + _windowReadings / 2) / _windowReadings);
+}
+
+//Largest distance of the averaged raw signals from their reference, in counts
+uint16_t SGP30HealthMonitor::drift(void)
+{
+  if (_rawReadings == 0 || referenceH2 == 0 || referenceEthanol == 0)
+    return 0;
+  int32_t driftH2 = ((_averageH2 + 128) >> 8) - referenceH2;
+  int32_t driftEthanol = ((_averageEthanol + 128) >> 8) - referenceEthanol;
+  if (driftH2 < 0)
+    driftH2 = -driftH2;
+  if (driftEthanol < 0)
+    driftEthanol = -driftEthanol;
+  return (uint16_t)(driftH2 > driftEthanol ? driftH2 : driftEthanol);
+}
+
+//True while readings keep repeating
+bool SGP30HealthMonitor::stuck(void)
+{
+  return _sameRawSignals >= SGP30_STUCK_RAW_SIGNALS || _sameAirQuality >= SGP30_STUCK_AIR_QUALITY;
+}
+
+//Health from 100 down to 0
+uint8_t SGP30HealthMonitor::score(void)
+{
+  if (lastTest == SGP30_SELF_TEST_FAIL)
+    return 0;
+  int16_t score = 100;
+  if (stuck())
+    score -= 40;
+  uint16_t rate = errorRate() / 4;
+  score -= rate > 30 ? 30 : (int16_t)rate;
+  uint32_t drifted = (uint32_t)drift() * 15 / 512;
+  score -= drifted > 30 ? 30 : (int16_t)drifted;
+  return score < 0 ? 0 : (uint8_t)score;
+}
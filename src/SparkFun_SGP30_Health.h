@@ -0,0 +1,140 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Health monitoring for a running SGP30.
+
+  The on chip self test takes 220ms and wipes the air quality state, so it
+  is normally only run at power up. SGP30HealthMonitor runs it whenever
+  startTest() asks for it, in steps driven by update() from loop():
+    - the baseline is read and kept
+    - the self test is started, update() returns right away while it runs
+    - once it is done, initAirQuality() and the saved baseline bring the
+      sensor back where it was (these two block for 10ms each, like
+      SGP30::reinitialize())
+  Measurements started during the test get SGP30_ERR_BUSY, which
+  SGP30Scheduler simply retries. A step whose command is dropped before
+  it is read, by a reset or cancel(), is run again rather than waited for. Pick a quiet moment for the test: the
+  sensor reports its fixed 400 ppm / 0 ppb for 15 seconds after the re-init.
+
+  Between tests it watches the readings passed to recordAirQuality() and
+  recordRawSignals():
+    - bus error rate (bad CRCs and timeouts) over the last few hundred readings
+    - stuck values: identical raw signals, or identical CO2 and TVOC away
+      from the 400 ppm / 0 ppb floor, reading after reading
+    - drift: how far a slow average of the raw H2 and ethanol signals moved
+      from their reference (the first readings, or referenceH2 and
+      referenceEthanol if set). 512 counts is a factor of e in concentration
+  score() sums them up, from 100 (healthy) down to 0:
+    - a failed self test: 0
+    - stuck: -40
+    - error rate: -1 per 4 errors per thousand readings, up to -30
+    - drift: -15 per 512 counts, up to -30
+*/
+
+#ifndef SparkFun_SGP30_Health_h
+#define SparkFun_SGP30_Health_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+//Identical readings in a row before values count as stuck
+#define SGP30_STUCK_RAW_SIGNALS 10
+#define SGP30_STUCK_AIR_QUALITY 300
+
+//Raw readings averaged into the reference when none was set
+#define SGP30_HEALTH_REFERENCE_SAMPLES 16
+
+class SGP30HealthMonitor
+{
+public:
+  //Self tests run and failed since begin()
+  unsigned long tests;
+  unsigned long testFailures;
+
+  //Result of the last self test, SGP30_ERR_NOT_READY until one has run
+  SGP30ERR lastTest;
+
+  //Readings recorded since begin(), and how many failed on the bus
+  unsigned long readings;
+  unsigned long crcErrors;
+  unsigned long timeouts;
+
+  //Raw signals drift is measured from, 0 to take them from the first readings
+  uint16_t referenceH2;
+  uint16_t referenceEthanol;
+
+  SGP30HealthMonitor();
+
+  //Monitors sensor, call after initAirQuality()
+  void begin(SGP30 &sensor);
+
+  //Asks for a self test, run by update() as soon as the sensor is idle
+  void startTest(void);
+
+  //True from startTest() until the sensor is back to measuring
+  bool testing(void) { return _step != _IDLE; }
+
+  //Call from loop() as often as convenient, runs the next step of a test
+  //Returns the result of the test when it finishes (SGP30_SUCCESS,
+  //SGP30_SELF_TEST_FAIL or a bus error), otherwise SGP30_ERR_NOT_READY
+  SGP30ERR update(void);
+
+  //Pass the result of every air quality reading (measureAirQuality(),
+  //readAirQuality() or SGP30Scheduler::update() when not SGP30_ERR_NOT_READY)
+  void recordAirQuality(SGP30ERR error);
+
+  //Same for measureRawSignals() or readRawSignals()
+  void recordRawSignals(SGP30ERR error);
+
+  //Health from 100 down to 0
+  uint8_t score(void);
+
+  //Bus errors per thousand recent readings
+  uint16_t errorRate(void);
+
+  //Largest distance of the averaged raw signals from their reference, in counts
+  uint16_t drift(void);
+
+  //True while readings keep repeating
+  bool stuck(void);
+
+private:
+  enum
+  {
+    _IDLE = 0,
+    _SAVE_BASELINE, //start reading the baseline
+    _READ_BASELINE, //keep it
+    _START_TEST,    //start the test
+    _TEST           //collect the result, re-init
+  };
+
+  SGP30 *_sensor;
+  uint8_t _step;
+  uint16_t _savedCO2;
+  uint16_t _savedTVOC;
+
+  //Error rate over a window that halves every 256 readings
+  uint16_t _windowReadings;
+  uint16_t _windowErrors;
+
+  //Stuck detection
+  uint16_t _lastCO2;
+  uint16_t _lastTVOC;
+  uint16_t _lastH2;
+  uint16_t _lastEthanol;
+  uint16_t _sameAirQuality;
+  uint16_t _sameRawSignals;
+
+  //Raw signals averaged with weight 1/64, in 1/256 counts
+  int32_t _averageH2;
+  int32_t _averageEthanol;
+  uint32_t _referenceSumH2;
+  uint32_t _referenceSumEthanol;
+  uint16_t _rawReadings;
+
+  //Counts a reading and whether it failed on the bus
+  void _count(SGP30ERR error);
+};
+
+#endif
@@ -0,0 +1,206 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Fixed capacity history of timestamped SGP30 readings, see SparkFun_SGP30_History.h
+*/
+
+#include "SparkFun_SGP30_History.h"
+
+//Values of a sample indexed by SGP30SIGNAL
+static inline uint16_t _signal(const SGP30Sample &sample, uint8_t signal)
+{
+  switch (signal)
+  {
+  case SGP30_SIGNAL_CO2:
+    return sample.CO2;
+  case SGP30_SIGNAL_TVOC:
+    return sample.TVOC;
+  case SGP30_SIGNAL_H2:
+    return sample.H2;
+  default:
+    return sample.ethanol;
+  }
+}
+
+//Measurement that carries a signal
+static inline uint8_t _source(uint8_t signal)
+{
+  return signal < SGP30_SIGNAL_H2 ? SGP30_HISTORY_AIR_QUALITY : SGP30_HISTORY_RAW_SIGNALS;
+}
+
+SGP30HistoryBase::SGP30HistoryBase(SGP30Sample *buffer, uint8_t *sources, uint16_t capacity)
+{
+  _buffer = buffer;
+  _carries = sources;
+  _capacity = capacity;
+  _sources = SGP30_HISTORY_AIR_QUALITY;
+  _emaShift = 3;
+  _windowLength[SGP30_WINDOW_1MIN] = 60000UL;
+  _windowLength[SGP30_WINDOW_15MIN] = 900000UL;
+  clear();
+}
+
+//Records the measurements it was attached for
+void SGP30HistoryBase::onSample(SGP30 &, const SGP30Sample &sample, uint8_t source)
+{
+  if (_sources & source)
+    push(sample, source);
+}
+
+//Forgets every sample and resets the statistics
+void SGP30HistoryBase::clear(void)
+{
+  _head = 0;
+  _count = 0;
+  for (uint8_t s = 0; s < SGP30_SIGNALS; s++)
+  {
+    _min[s] = 0xFFFF;
+    _max[s] = 0;
+    _sum[s] = 0;
+    _ema[s] = 0;
+  }
+  _carried[0] = _carried[1] = 0;
+  for (uint8_t w = 0; w < SGP30_WINDOWS; w++)
+  {
+    _windowTail[w] = 0;
+    _windowCount[w] = 0;
+    _windowCarried[w][0] = _windowCarried[w][1] = 0;
+    for (uint8_t s = 0; s < SGP30_SIGNALS; s++)
+      _windowSum[w][s] = 0;
+  }
+}
+
+//Changes a window length, clears the history so every window stays consistent
+void SGP30HistoryBase::setWindow(uint8_t window, unsigned long length)
+{
+  if (window >= SGP30_WINDOWS)
+    return;
+  _windowLength[window] = length;
+  clear();
+}
+
+//Adds a sample, overwriting the oldest one when full
+//Every statistic is updated here, amortized O(1)
+void SGP30HistoryBase::push(const SGP30Sample &sample, uint8_t sources)
+{
+  if (_capacity == 0)
+    return;
+
+  //Drop the oldest sample from every running sum before overwriting it
+  if (_count == _capacity)
+  {
+    const SGP30Sample &oldest = _buffer[_head];
+    _accumulate(_sum, _carried, oldest, _carries[_head], false);
+    for (uint8_t w = 0; w < SGP30_WINDOWS; w++)
+    {
+      if (_windowCount[w] > 0 && _windowTail[w] == _head)
+      {
+        _accumulate(_windowSum[w], _windowCarried[w], oldest, _carries[_head], false);
+        _windowTail[w] = (_windowTail[w] + 1) % _capacity;
+        _windowCount[w]--;
+      }
+    }
+    _count--;
+  }
+
+  _buffer[_head] = sample;
+  _carries[_head] = sources;
+  uint16_t index = _head;
+  _head = (_head + 1) % _capacity;
+  _count++;
+
+  _accumulate(_sum, _carried, sample, sources, true);
+  for (uint8_t s = 0; s < SGP30_SIGNALS; s++)
+  {
+    if (!(sources & _source(s)))
+      continue;
+    uint16_t value = _signal(sample, s);
+    if (_max[s] < _min[s])
+      _ema[s] = (int32_t)value << 8; //first sample since clear() seeds the average
+    else
+      _ema[s] += (((int32_t)value << 8) - _ema[s]) >> _emaShift;
+    if (value < _min[s])
+      _min[s] = value;
+    if (value > _max[s])
+      _max[s] = value;
+  }
+
+  //Add to each window, then expire samples that fell out of it
+  for (uint8_t w = 0; w < SGP30_WINDOWS; w++)
+  {
+    if (_windowCount[w] == 0)
+      _windowTail[w] = index;
+    _accumulate(_windowSum[w], _windowCarried[w], sample, sources, true);
+    _windowCount[w]++;
+    while (_windowCount[w] > 1 && (uint32_t)(sample.timestamp - _buffer[_windowTail[w]].timestamp) >= _windowLength[w])
+    {
+      _accumulate(_windowSum[w], _windowCarried[w], _buffer[_windowTail[w]], _carries[_windowTail[w]], false);
+      _windowTail[w] = (_windowTail[w] + 1) % _capacity;
+      _windowCount[w]--;
+    }
+  }
+}
+
+//Returns a sample by age, 0 is the newest
+SGP30Sample SGP30HistoryBase::get(uint16_t age)
+{
+  SGP30Sample sample = {0, 0, 0, 0, 0};
+  if (age < _count)
+    sample = _buffer[(_head + _capacity - 1 - age) % _capacity];
+  return sample;
+}
+
+//Measurements a sample by age carries
+uint8_t SGP30HistoryBase::sources(uint16_t age)
+{
+  if (age >= _count)
+    return 0;
+  return _carries[(_head + _capacity - 1 - age) % _capacity];
+}
+
+//Mean of the samples currently held that carry the signal
+uint16_t SGP30HistoryBase::mean(SGP30SIGNAL signal)
+{
+  uint16_t count = _carried[_source(signal) - 1];
+  if (count == 0)
+    return 0;
+  return (_sum[signal] + count / 2) / count;
+}
+
+//Exponential moving average
+uint16_t SGP30HistoryBase::ema(SGP30SIGNAL signal)
+{
+  return (uint16_t)((_ema[signal] + 0x80) >> 8);
+}
+
+//Mean of the samples no older than the window, as of the newest sample
+uint16_t SGP30HistoryBase::windowMean(SGP30SIGNAL signal, uint8_t window)
+{
+  if (window >= SGP30_WINDOWS)
+    return 0;
+  uint16_t count = _windowCarried[window][_source(signal) - 1];
+  if (count == 0)
+    return 0;
+  return (_windowSum[window][signal] + count / 2) / count;
+}
+
+//Adds or removes the signals a sample carries from a set of running sums,
+//and counts it for each measurement it carries
+void SGP30HistoryBase::_accumulate(uint32_t *sums, uint16_t *carried, const SGP30Sample &sample, uint8_t sources, bool add)
+{
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    if (sources & (1 << i))
+      carried[i] += add ? 1 : -1;
+  }
+  for (uint8_t s = 0; s < SGP30_SIGNALS; s++)
+  {
+    if (!(sources & _source(s)))
+      continue;
+    if (add)
+      sums[s] += _signal(sample, s);
+    else
+      sums[s] -= _signal(sample, s);
+  }
+}
@@ -0,0 +1,132 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Fixed capacity history of timestamped SGP30 readings.
+  SGP30History<Capacity> keeps the last Capacity samples without using the
+  heap, so its RAM use is known at compile time (13 bytes per sample).
+  Statistics are updated as each sample is pushed and read back in
+  constant time:
+    minimum / maximum  since the last clear()
+    mean               of the samples currently held
+    EMA                exponential moving average, alpha = 1/2^shift
+    window mean        of the samples in the last 1 minute / 15 minutes
+  A window can only cover samples still held in the buffer, so at one
+  sample per second a full 15 minute window needs a capacity of 900.
+  Each sample remembers the measurements it carries: an air quality
+  sample only counts for CO2 and TVOC, a raw signal sample for H2 and
+  ethanol, so a history fed both keeps separate statistics for each.
+*/
+
+#ifndef SparkFun_SGP30_History_h
+#define SparkFun_SGP30_History_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_Observer.h"
+
+//Signals tracked by the statistics
+typedef enum
+{
+  SGP30_SIGNAL_CO2 = 0,
+  SGP30_SIGNAL_TVOC,
+  SGP30_SIGNAL_H2,
+  SGP30_SIGNAL_ETHANOL
+} SGP30SIGNAL;
+
+#define SGP30_SIGNALS 4
+
+//Windowed averages
+#define SGP30_WINDOW_1MIN 0
+#define SGP30_WINDOW_15MIN 1
+#define SGP30_WINDOWS 2
+
+class SGP30HistoryBase : public SGP30Observer
+{
+public:
+  //Adds a sample, overwriting the oldest one when full
+  //Samples must be pushed in timestamp order
+  //sources tells the signals it carries, the statistics of the others are left alone
+  void push(const SGP30Sample &sample, uint8_t sources = SGP30_HISTORY_AIR_QUALITY | SGP30_HISTORY_RAW_SIGNALS);
+
+  //Forgets every sample and resets the statistics
+  void clear(void);
+
+  //Number of samples held and the most that can be held
+  uint16_t size(void) { return _count; }
+  uint16_t capacity(void) { return _capacity; }
+
+  //Returns a sample by age, 0 is the newest
+  //Returns a zeroed sample if age >= size()
+  //Signals the sample doesn't carry hold the values of an earlier measurement
+  SGP30Sample get(uint16_t age);
+
+  //Measurements a sample by age carries, 0 if age >= size()
+  uint8_t sources(uint16_t age);
+
+  //Smallest and largest value since clear()
+  uint16_t minimum(SGP30SIGNAL signal) { return _min[signal]; }
+  uint16_t maximum(SGP30SIGNAL signal) { return _max[signal]; }
+
+  //Mean of the samples currently held that carry the signal
+  uint16_t mean(SGP30SIGNAL signal);
+
+  //Exponential moving average, alpha = 1/2^shift (default 3 = 1/8)
+  //shift is capped at 16, beyond that the average would stop moving
+  uint16_t ema(SGP30SIGNAL signal);
+  void setEMAShift(uint8_t shift) { _emaShift = shift > 16 ? 16 : shift; }
+
+  //Mean of the samples no older than the window, as of the newest sample
+  //windowCount() counts every sample in the window, whatever it carries
+  uint16_t windowMean(SGP30SIGNAL signal, uint8_t window);
+  uint16_t windowCount(uint8_t window) { return window < SGP30_WINDOWS ? _windowCount[window] : 0; }
+
+  //Changes a window length, default 60000 and 900000 ms, clears the history
+  void setWindow(uint8_t window, unsigned long length);
+
+  //Measurements that add a sample once attached to an SGP30
+  //SGP30_HISTORY_AIR_QUALITY (default) and/or SGP30_HISTORY_RAW_SIGNALS
+  void setSources(uint8_t sources) { _sources = sources; }
+
+  //Called by SGP30 with each measurement
+  void onSample(SGP30 &sensor, const SGP30Sample &sample, uint8_t source);
+
+protected:
+  SGP30HistoryBase(SGP30Sample *buffer, uint8_t *sources, uint16_t capacity);
+
+private:
+  SGP30Sample *_buffer;
+  uint8_t *_carries; //SGP30_HISTORY_* of each sample
+  uint16_t _capacity;
+  uint16_t _head;  //next slot to write
+  uint16_t _count; //samples held
+  uint8_t _sources;
+
+  uint16_t _min[SGP30_SIGNALS];
+  uint16_t _max[SGP30_SIGNALS];
+  uint32_t _sum[SGP30_SIGNALS]; //of the samples held
+  uint16_t _carried[2];         //samples held with air quality / raw signals
+  int32_t _ema[SGP30_SIGNALS];  //8 fractional bits
+  uint8_t _emaShift;
+
+  unsigned long _windowLength[SGP30_WINDOWS];
+  uint32_t _windowSum[SGP30_WINDOWS][SGP30_SIGNALS];
+  uint16_t _windowCarried[SGP30_WINDOWS][2];
+  uint16_t _windowTail[SGP30_WINDOWS]; //oldest sample in the window
+  uint16_t _windowCount[SGP30_WINDOWS];
+
+  //Adds or removes the signals a sample carries from a set of running sums
+  static void _accumulate(uint32_t *sums, uint16_t *carried, const SGP30Sample &sample, uint8_t sources, bool add);
+};
+
+template <uint16_t Capacity>
+class SGP30History : public SGP30HistoryBase
+{
+public:
+  SGP30History() : SGP30HistoryBase(_storage, _sourceStorage, Capacity) {}
+
+private:
+  SGP30Sample _storage[Capacity];
+  uint8_t _sourceStorage[Capacity];
+};
+
+#endif
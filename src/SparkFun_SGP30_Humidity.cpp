@@ -0,0 +1,53 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Integer relative to absolute humidity conversion, see SparkFun_SGP30_Humidity.h
+*/
+
+#include "SparkFun_SGP30_Humidity.h"
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_word
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#endif
+
+#define SGP30_HUMIDITY_STEP 500 //table spacing, hundredths of a degree C
+#define SGP30_HUMIDITY_POINTS 19
+
+//Absolute humidity of saturated air (100% RH) in 1/256 g/m^3, -20C to 70C every 5C
+//eSat = 6.11 * 10^(7.5 * T / (237.7 + T)), AH = 1000 * 100 * eSat / ((T + 273) * 461.5)
+static const uint16_t _saturation[SGP30_HUMIDITY_POINTS] PROGMEM = {
+    274, 411, 604, 873, 1242, 1740, 2405, 3280, 4419, 5883,
+    7747, 10096, 13028, 16654, 21103, 26517, 33056, 40898, 50237};
+
+uint16_t sgp30AbsoluteHumidity(int16_t temperature, uint16_t relativeHumidity)
+{
+  if (temperature < SGP30_HUMIDITY_MIN_TEMPERATURE)
+    temperature = SGP30_HUMIDITY_MIN_TEMPERATURE;
+  if (temperature > SGP30_HUMIDITY_MAX_TEMPERATURE)
+    temperature = SGP30_HUMIDITY_MAX_TEMPERATURE;
+  if (relativeHumidity > 10000)
+    relativeHumidity = 10000;
+
+  //Three table points starting at i, the last interval reuses the one before it
+  int32_t offset = (int32_t)temperature - SGP30_HUMIDITY_MIN_TEMPERATURE;
+  uint8_t i = offset / SGP30_HUMIDITY_STEP;
+  if (i > SGP30_HUMIDITY_POINTS - 3)
+    i = SGP30_HUMIDITY_POINTS - 3;
+  int32_t f = offset - (int32_t)i * SGP30_HUMIDITY_STEP; //0 to 2 steps
+  int32_t y0 = pgm_read_word(&_saturation[i]);
+  int32_t y1 = pgm_read_word(&_saturation[i + 1]);
+  int32_t y2 = pgm_read_word(&_saturation[i + 2]);
+
+  //Newton forward difference: y0 + f*d1 + f*(f-1)/2*d2, with f in steps
+  int32_t saturation = y0 + (y1 - y0) * f / SGP30_HUMIDITY_STEP +
+                       ((y2 - 2 * y1 + y0) * f / SGP30_HUMIDITY_STEP) * (f - SGP30_HUMIDITY_STEP) / (2 * SGP30_HUMIDITY_STEP);
+
+  uint32_t absolute = ((uint32_t)saturation * relativeHumidity + 5000) / 10000;
+  if (absolute == 0)
+    absolute = 1; //0 turns compensation off, report the driest value instead
+  return (uint16_t)absolute;
+}
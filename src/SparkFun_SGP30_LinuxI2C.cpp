@@ -0,0 +1,81 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Linux i2c-dev transport, see SparkFun_SGP30_LinuxI2C.h
+*/
+
+#include "SparkFun_SGP30_LinuxI2C.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+SGP30LinuxI2C::SGP30LinuxI2C()
+{
+  syscalls = 0;
+  _fd = -1;
+}
+
+SGP30LinuxI2C::~SGP30LinuxI2C()
+{
+  end();
+}
+
+//Opens an i2c-dev device, e.g. "/dev/i2c-1"
+bool SGP30LinuxI2C::begin(const char *device)
+{
+  end();
+  _fd = open(device, O_RDWR | O_CLOEXEC);
+  return _fd >= 0;
+}
+
+//Opens /dev/i2c-bus
+bool SGP30LinuxI2C::begin(uint8_t bus)
+{
+  char device[16];
+  snprintf(device, sizeof(device), "/dev/i2c-%u", bus);
+  return begin(device);
+}
+
+void SGP30LinuxI2C::end(void)
+{
+  if (_fd >= 0)
+    close(_fd);
+  _fd = -1;
+}
+
+bool SGP30LinuxI2C::write(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  //The kernel only reads from the buffer of a write message
+  return _transfer(address, 0, const_cast<uint8_t *>(data), length);
+}
+
+bool SGP30LinuxI2C::read(uint8_t address, uint8_t *data, uint8_t length)
+{
+  return _transfer(address, I2C_M_RD, data, length);
+}
+
+//Start, address, data and stop in one syscall
+bool SGP30LinuxI2C::_transfer(uint8_t address, uint16_t flags, uint8_t *data, uint8_t length)
+{
+  if (_fd < 0)
+    return false;
+  struct i2c_msg message;
+  message.addr = address;
+  message.flags = flags;
+  message.len = length;
+  message.buf = data;
+  struct i2c_rdwr_ioctl_data transfer;
+  transfer.msgs = &message;
+  transfer.nmsgs = 1;
+  syscalls++;
+  return ioctl(_fd, I2C_RDWR, &transfer) == 1; //number of messages transferred
+}
+
+#endif
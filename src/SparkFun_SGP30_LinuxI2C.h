@@ -0,0 +1,64 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  SGP30 transport for Linux i2c-dev (/dev/i2c-N), for gateways that run
+  the driver outside of Arduino.
+
+  Every frame is a single ioctl(I2C_RDWR) that carries its own address, so
+  a command costs one syscall, its response one more, and switching
+  between devices (multiplexers, general call) needs no I2C_SLAVE ioctl.
+  The SGP30 needs a stop and its processing time between a command and
+  the response, so the two can't share one transfer. Sleep through that
+  time with the blocking measure*() calls, or from an event loop use
+  start*() / read*() and hand msUntilReady() to poll() as the timeout.
+
+  Only built on Linux hosts, not by the Arduino IDE.
+*/
+
+#ifndef SparkFun_SGP30_LinuxI2C_h
+#define SparkFun_SGP30_LinuxI2C_h
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "SparkFun_SGP30_Transport.h"
+
+class SGP30LinuxI2C : public SGP30Transport
+{
+public:
+  //ioctl()s issued, to keep an eye on the syscall count
+  unsigned long syscalls;
+
+  SGP30LinuxI2C();
+  ~SGP30LinuxI2C();
+
+  //Opens an i2c-dev device, e.g. "/dev/i2c-1"
+  //Returns false if it can't be opened (errno tells why)
+  bool begin(const char *device);
+
+  //Opens /dev/i2c-bus
+  bool begin(uint8_t bus);
+
+  //Closes the device
+  void end(void);
+
+  //The open file descriptor, -1 if closed
+  int fd(void) { return _fd; }
+
+  bool write(uint8_t address, const uint8_t *data, uint8_t length);
+  bool read(uint8_t address, uint8_t *data, uint8_t length);
+
+private:
+  int _fd;
+
+  //One message in one I2C_RDWR ioctl
+  bool _transfer(uint8_t address, uint16_t flags, uint8_t *data, uint8_t length);
+
+  //Owns a file descriptor, not copyable
+  SGP30LinuxI2C(const SGP30LinuxI2C &);
+  SGP30LinuxI2C &operator=(const SGP30LinuxI2C &);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,143 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Compact binary log of SGP30 samples, see SparkFun_SGP30_Log.h
+*/
+
+#include "SparkFun_SGP30_Log.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+SGP30LogEncoder::SGP30LogEncoder(Print &output)
+{
+  _output = &output;
+  _keyframeInterval = 60;
+  _batch = 1;
+  begin(0, 0);
+}
+
+//Starts a new stream, the next sample is a keyframe preceded by a header
+void SGP30LogEncoder::begin(uint64_t serialID, uint16_t featureSetVersion, uint16_t period)
+{
+  _serialID = serialID;
+  _featureSetVersion = featureSetVersion;
+  _period = period;
+  _started = false;
+  _sinceKey = 0;
+  _chain = 0;
+  _pending = 0;
+  _length = 0;
+  SGP30Sample none = {0, 0, 0, 0, 0};
+  _previous = none;
+  bytes = 0;
+  samples = 0;
+}
+
+//Takes the serial ID and feature set read by SGP30::begin()
+void SGP30LogEncoder::begin(SGP30 &sensor, uint16_t period)
+{
+  begin(sensor.serialID, sensor.featureSetVersion, period);
+}
+
+void SGP30LogEncoder::setKeyframeInterval(uint16_t samples)
+{
+  _keyframeInterval = samples ? samples : 1;
+}
+
+void SGP30LogEncoder::setBatch(uint8_t samples)
+{
+  if (samples < 1)
+    samples = 1;
+  if (samples > SGP30_LOG_MAX_BATCH)
+    samples = SGP30_LOG_MAX_BATCH;
+  _batch = samples;
+}
+
+//Logs a sample as a keyframe when one is due, as a delta otherwise
+size_t SGP30LogEncoder::write(const SGP30Sample &sample)
+{
+  size_t written = 0;
+  int32_t deviation = (int32_t)(uint32_t)(sample.timestamp - _previous.timestamp) - _period;
+  if (!_started || _sinceKey >= _keyframeInterval || deviation < -32768 || deviation > 32767)
+  {
+    written += flush();
+    _length = 0;
+    _frame[3 + _length++] = SGP30_LOG_VERSION;
+    for (int8_t shift = 40; shift >= 0; shift -= 8)
+      _frame[3 + _length++] = (uint8_t)(_serialID >> shift);
+    _varint(_featureSetVersion);
+    _varint(_period);
+    written += _writeFrame(SGP30_LOG_HEADER);
+
+    _length = 0;
+    _varint((uint32_t)sample.timestamp);
+    _varint(sample.CO2);
+    _varint(sample.TVOC);
+    _varint(sample.H2);
+    _varint(sample.ethanol);
+    written += _writeFrame(SGP30_LOG_KEYFRAME);
+    _started = true;
+    _sinceKey = 0;
+  }
+  else
+  {
+    _signed(deviation);
+    _signed((int32_t)sample.CO2 - _previous.CO2);
+    _signed((int32_t)sample.TVOC - _previous.TVOC);
+    _signed((int32_t)sample.H2 - _previous.H2);
+    _signed((int32_t)sample.ethanol - _previous.ethanol);
+    if (++_pending >= _batch)
+      written += flush();
+  }
+  _previous = sample;
+  _sinceKey++;
+  samples++;
+  return written;
+}
+
+//Writes out the delta frame being built, if any
+size_t SGP30LogEncoder::flush(void)
+{
+  if (_pending == 0)
+    return 0;
+  _pending = 0;
+  return _writeFrame(SGP30_LOG_DELTA);
+}
+
+//Frames the _length payload bytes at _frame[3] and writes them out
+size_t SGP30LogEncoder::_writeFrame(uint8_t type)
+{
+  _frame[1] = type;
+  _frame[2] = _length;
+  //Delta frames chain on the previous CRC, fed in where the sync byte goes
+  if (type == SGP30_LOG_DELTA)
+  {
+    _frame[0] = _chain;
+    _chain = sgp30CRC8(_frame, _length + 3);
+  }
+  else
+    _chain = sgp30CRC8(_frame + 1, _length + 2);
+  _frame[0] = SGP30_LOG_SYNC;
+  _frame[3 + _length] = _chain;
+  size_t written = _output->write(_frame, _length + SGP30_LOG_FRAMING);
+  _length = 0;
+  bytes += written;
+  return written;
+}
+
+//Appends an unsigned LEB128 varint to the payload
+void SGP30LogEncoder::_varint(uint32_t value)
+{
+  while (value >= 0x80)
+  {
+    _frame[3 + _length++] = (uint8_t)value | 0x80;
+    value >>= 7;
+  }
+  _frame[3 + _length++] = (uint8_t)value;
+}
+
+//Zigzag maps small magnitudes of either sign to small varints: 0, -1, 1, -2...
+void SGP30LogEncoder::_signed(int32_t value)
+{
+  _varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
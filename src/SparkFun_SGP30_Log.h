@@ -0,0 +1,104 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Compact binary log of SGP30 samples, for SD cards and serial links.
+  SGP30LogEncoder writes a stream of frames to any Print (Serial, File...):
+    sync(0xA5) / type / payload length / payload / CRC
+  Frame types:
+    - header: format version, sensor serial ID (6 bytes), feature set
+      version and nominal sample period, all varints after the serial ID
+    - keyframe: one sample with absolute values
+    - delta: one or more samples, each as the difference from the previous
+      one (timestamp as the difference from the nominal period), zigzag
+      varint encoded
+  A header and a keyframe are written every setKeyframeInterval() samples.
+  The CRC is sgp30CRC8 over type, length and payload. For delta frames the
+  CRC of the previous frame is fed in first, so a delta only checks out
+  right after the frame it was encoded against.
+  A reader that starts mid-stream, or hits a truncated or corrupted frame,
+  scans for the next sync byte with a valid CRC and drops deltas until the
+  next keyframe, so damage never yields a wrong sample and loses at most one
+  keyframe interval. See extras/host/sgp30_log.cpp for a decoder.
+*/
+
+#ifndef SparkFun_SGP30_Log_h
+#define SparkFun_SGP30_Log_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_History.h"
+
+class SGP30;
+
+#define SGP30_LOG_SYNC 0xA5
+#define SGP30_LOG_VERSION 1
+
+//Frame types
+typedef enum
+{
+  SGP30_LOG_HEADER = 1,
+  SGP30_LOG_KEYFRAME,
+  SGP30_LOG_DELTA,
+} SGP30LOGFRAME;
+
+//Most samples held in one delta frame
+#define SGP30_LOG_MAX_BATCH 8
+
+//Largest encoded sample: timestamp deviation (int16) and 4 deltas (int17), 3 bytes each
+#define SGP30_LOG_MAX_SAMPLE 15
+
+//Sync, type, length and CRC around the payload
+#define SGP30_LOG_FRAMING 4
+
+class SGP30LogEncoder
+{
+public:
+  //Bytes written to the output and samples logged since begin()
+  unsigned long bytes;
+  unsigned long samples;
+
+  SGP30LogEncoder(Print &output);
+
+  //Starts a new stream for a sensor, period is the nominal sample period in ms
+  //The header goes out with the first keyframe
+  void begin(uint64_t serialID, uint16_t featureSetVersion, uint16_t period = 1000);
+  void begin(SGP30 &sensor, uint16_t period = 1000);
+
+  //Samples between keyframes, default 60. Also bounds what a damaged frame can lose
+  void setKeyframeInterval(uint16_t samples);
+
+  //Samples per delta frame, 1 (default) to SGP30_LOG_MAX_BATCH
+  //Larger batches save framing bytes but hold samples back until the frame is full
+  void setBatch(uint8_t samples);
+
+  //Logs a sample, returns the bytes written to the output (0 while batching)
+  //Samples must be written in timestamp order
+  size_t write(const SGP30Sample &sample);
+
+  //Writes out a partially filled delta frame
+  size_t flush(void);
+
+private:
+  Print *_output;
+  uint64_t _serialID;
+  uint16_t _featureSetVersion;
+  uint16_t _period;
+  uint16_t _keyframeInterval;
+  uint8_t _batch;
+
+  SGP30Sample _previous;
+  bool _started;       //a keyframe has been written
+  uint16_t _sinceKey;  //samples since the last keyframe
+  uint8_t _chain;      //CRC of the last frame written
+  uint8_t _pending;    //samples in the delta frame being built
+
+  //Frame under construction, payload starts at _frame[3]
+  uint8_t _frame[SGP30_LOG_FRAMING + SGP30_LOG_MAX_BATCH * SGP30_LOG_MAX_SAMPLE];
+  uint8_t _length;
+
+  size_t _writeFrame(uint8_t type);
+  void _varint(uint32_t value);
+  void _signed(int32_t value);
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Hooks of the SGP30 driver.
+  History, alerts, the baseline manager and recovery are observers: once
+  attached to an SGP30 the driver calls them at each step of a
+  measurement, through virtual functions only. A sketch that never creates
+  one of them doesn't link its code, and one that does pays one call per
+  step. An observer is attached to one sensor at a time.
+*/
+
+#ifndef SparkFun_SGP30_Observer_h
+#define SparkFun_SGP30_Observer_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_Core.h"
+
+class SGP30;
+
+//One timestamped reading
+struct SGP30Sample
+{
+  unsigned long timestamp; //millis() when the measurement was started
+  uint16_t CO2;
+  uint16_t TVOC;
+  uint16_t H2;
+  uint16_t ethanol;
+};
+
+//Measurements that produce a sample: CO2 and TVOC, or H2 and ethanol
+#define SGP30_HISTORY_AIR_QUALITY 0x01
+#define SGP30_HISTORY_RAW_SIGNALS 0x02
+
+class SGP30Observer
+{
+public:
+  SGP30Observer() { _next = NULL; }
+
+  //After initAirQuality() has been acknowledged
+  virtual void onInit(SGP30 &) {}
+
+  //In place of the plain measurement in measureAirQuality(): return true
+  //once the reading was taken, with its outcome in error
+  virtual bool measure(SGP30 &, SGP30ERR &) { return false; }
+
+  //Outcome of every air quality reading, before it is published
+  //Return false to keep the previous CO2 and TVOC
+  virtual bool onAirQuality(SGP30 &, SGP30ERR) { return true; }
+
+  //Every successful measurement once published
+  //source is SGP30_HISTORY_AIR_QUALITY or SGP30_HISTORY_RAW_SIGNALS
+  virtual void onSample(SGP30 &, const SGP30Sample &, uint8_t) {}
+
+private:
+  friend class SGP30;
+  SGP30Observer *_next; //next observer of the same sensor
+};
+
+#endif
@@ -0,0 +1,135 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Automatic fault recovery, see SparkFun_SGP30_Recovery.h
+*/
+
+#include "SparkFun_SGP30_Recovery.h"
+
+SGP30Recovery::SGP30Recovery()
+{
+  retried = 0;
+  resets = 0;
+  recoveries = 0;
+  _retries = 2;
+  _backoff = 5;
+  _maxBackoff = 100;
+  _escalation = 3;
+  _maxResets = 4;
+  _failures = 0;
+  _needed = _escalation;
+  _fruitless = 0;
+  _gaveUp = false;
+  _unrecovered = false;
+  _initialized = false;
+  _initTime = 0;
+  _published = false;
+  _holding = false;
+  _recovering = false;
+}
+
+//Attempts repeated by measureAirQuality() and the wait between them
+void SGP30Recovery::setRetries(uint8_t retries, uint16_t backoff, uint16_t maxBackoff)
+{
+  _retries = retries;
+  _backoff = backoff;
+  _maxBackoff = maxBackoff;
+}
+
+//Failed readings in a row before the sensor is re-initialized, and
+//resets without a good reading before giving up
+void SGP30Recovery::setEscalation(uint8_t failures, uint8_t maxResets)
+{
+  _escalation = failures;
+  _maxResets = maxResets;
+  _needed = failures;
+}
+
+SGP30STATE SGP30Recovery::state(void)
+{
+  if (_gaveUp)
+    return SGP30_STATE_FAILED;
+  if (_failures > 0 || _unrecovered)
+    return SGP30_STATE_DEGRADED;
+  if (!_initialized || (uint32_t)(millis() - _initTime) < SGP30_WARMUP_TIME)
+    return SGP30_STATE_WARMUP;
+  return SGP30_STATE_OK;
+}
+
+//Called by SGP30::initAirQuality()
+void SGP30Recovery::onInit(SGP30 &)
+{
+  _initialized = true;
+  _initTime = millis();
+  //After a recovery the last real reading is better than the fixed warm-up values
+  _holding = _recovering && _published;
+  if (_recovering)
+    return;
+  //Started again by the sketch: a clean slate
+  _published = false;
+  _failures = 0;
+  _needed = _escalation;
+  _fruitless = 0;
+  _gaveUp = false;
+  _unrecovered = false;
+}
+
+//Measures with retries, every reading goes through onAirQuality()
+bool SGP30Recovery::measure(SGP30 &sensor, SGP30ERR &error)
+{
+  uint16_t backoff = _backoff;
+  for (uint8_t attempt = 0;; attempt++)
+  {
+    error = sensor.startAirQuality();
+    if (error == SGP30_SUCCESS)
+    {
+      while (!sensor.isReady())
+        delay(sensor.msUntilReady());
+      error = sensor.readAirQuality();
+    }
+    //NOT_READY: read fine, held during the warm-up after a recovery
+    if (error == SGP30_SUCCESS || error == SGP30_ERR_BUSY || error == SGP30_ERR_NOT_READY || attempt >= _retries)
+      return true;
+    retried++;
+    delay(backoff);
+    backoff = backoff > _maxBackoff / 2 ? _maxBackoff : backoff * 2;
+  }
+}
+
+//Outcome of an air quality reading
+bool SGP30Recovery::onAirQuality(SGP30 &sensor, SGP30ERR error)
+{
+  if (error == SGP30_SUCCESS)
+  {
+    _failures = 0;
+    _needed = _escalation;
+    _fruitless = 0;
+    _gaveUp = false;
+    _unrecovered = false;
+    if (_holding && (uint32_t)(millis() - _initTime) < SGP30_WARMUP_TIME)
+      return false;
+    _holding = false;
+    _published = true;
+    return true;
+  }
+  if (_failures < 0xFF)
+    _failures++;
+  if (_failures < _needed || _gaveUp || _recovering)
+    return false;
+  _recovering = true;
+  resets++;
+  _unrecovered = !sensor.reinitialize();
+  if (!_unrecovered)
+    recoveries++;
+  _recovering = false;
+  //Give the re-initialized sensor a full set of tries before escalating again,
+  //twice as many as last time: a sensor that is gone isn't reset every few readings
+  _failures = 0;
+  _needed = _needed > 0x7F ? 0xFF : _needed * 2;
+  if (_fruitless < 0xFF)
+    _fruitless++;
+  if (_maxResets != 0 && _fruitless >= _maxResets)
+    _gaveUp = true;
+  return false;
+}
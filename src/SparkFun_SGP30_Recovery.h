@@ -0,0 +1,100 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Automatic fault recovery for the SGP30.
+  Attached with SGP30::attachRecovery(), SGP30Recovery watches every air
+  quality reading:
+    - measureAirQuality() retries a failed measurement, waiting between
+      attempts with a backoff that doubles up to a limit
+    - after a number of failed readings in a row (retries included, and
+      readings collected with readAirQuality()) the sensor is reset and
+      brought back with SGP30::reinitialize(): general call reset, begin(),
+      initAirQuality(), then the last known baseline and humidity
+      compensation are written back, so the 12 hour calibration is kept
+    - each reset that isn't followed by a good reading doubles the failures
+      needed before the next one; after a number of such resets recovery
+      gives up (FAILED) until a good reading or a new initAirQuality()
+    - for the 15 seconds after such a recovery the sensor reports its
+      fixed 400 ppm / 0 ppb; those readings are not published, CO2 and
+      TVOC keep the last real values instead and the measurement returns
+      SGP30_ERR_NOT_READY
+  state() tells whether the published values are current (OK), from or
+  during warm-up (WARMUP), stale because the last reading or reset
+  failed (DEGRADED), or stale with no more resets to try (FAILED).
+  The general call reset reaches every device on the bus that supports it.
+*/
+
+#ifndef SparkFun_SGP30_Recovery_h
+#define SparkFun_SGP30_Recovery_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+typedef enum
+{
+  SGP30_STATE_WARMUP = 0, //first 15 seconds after init, values fixed or held
+  SGP30_STATE_OK,
+  SGP30_STATE_DEGRADED,   //last reading or reset failed, values are stale
+  SGP30_STATE_FAILED      //stale and recovery gave up resetting the sensor
+} SGP30STATE;
+
+//Time after init_air_quality during which the sensor reports fixed values
+#define SGP30_WARMUP_TIME 15000
+
+class SGP30Recovery : public SGP30Observer
+{
+public:
+  //Measurement attempts repeated, resets tried and times the sensor was
+  //re-initialized by them
+  unsigned long retried;
+  unsigned long resets;
+  unsigned long recoveries;
+
+  SGP30Recovery();
+
+  //Attempts repeated by measureAirQuality() before giving up, default 2
+  //waiting backoff ms before the first and doubling up to maxBackoff, default 5 and 100
+  void setRetries(uint8_t retries, uint16_t backoff = 5, uint16_t maxBackoff = 100);
+
+  //Failed readings in a row before the sensor is re-initialized, default 3,
+  //and resets without a good reading before giving up, default 4 (0 never)
+  void setEscalation(uint8_t failures, uint8_t maxResets = 4);
+
+  //Whether CO2 and TVOC are current
+  SGP30STATE state(void);
+
+  //Failed readings since the last good one
+  uint8_t failures(void) { return _failures; }
+
+  //Called by SGP30::initAirQuality(), starts the warm-up
+  void onInit(SGP30 &sensor);
+
+  //Called by SGP30::measureAirQuality(), measures with retries
+  bool measure(SGP30 &sensor, SGP30ERR &error);
+
+  //Called by SGP30 with the outcome of every air quality reading
+  //Re-initializes the sensor when failures pile up
+  //Returns false if a good reading must not be published (warm-up after a recovery)
+  bool onAirQuality(SGP30 &sensor, SGP30ERR error);
+
+private:
+  uint8_t _retries;
+  uint16_t _backoff;
+  uint16_t _maxBackoff;
+  uint8_t _escalation;
+  uint8_t _maxResets;
+
+  uint8_t _failures;
+  uint8_t _needed;     //failures before the next reset, doubles with each fruitless one
+  uint8_t _fruitless;  //resets since the last good reading
+  bool _gaveUp;
+  bool _unrecovered;   //the last reset failed, stale until a good reading
+  bool _initialized;   //init seen
+  unsigned long _initTime;
+  bool _published;     //a real reading has been published since init
+  bool _holding;       //warm-up after a recovery, keep the last real reading
+  bool _recovering;    //inside reinitialize(), its init is ours
+};
+
+#endif
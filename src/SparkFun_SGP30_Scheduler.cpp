@@ -0,0 +1,131 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Drift-free measurement scheduler, see SparkFun_SGP30_Scheduler.h
+*/
+
+#include "SparkFun_SGP30_Scheduler.h"
+
+SGP30Scheduler::SGP30Scheduler(unsigned long period)
+{
+  _sensor = NULL;
+  _period = period;
+  _deadline = 0;
+  _measuring = false;
+  resetStats();
+}
+
+//Schedules measurements on sensor, the first one right away
+void SGP30Scheduler::begin(SGP30 &sensor)
+{
+  _sensor = &sensor;
+  _deadline = millis();
+  _measuring = false;
+  resetStats();
+}
+
+void SGP30Scheduler::resetStats(void)
+{
+  ticks = 0;
+  missed = 0;
+  lost = 0;
+  minInterval = 0;
+  maxInterval = 0;
+  maxJitter = 0;
+  maxLateness = 0;
+  _consecutive = false;
+  _lastStart = 0;
+  _jitterSum = 0;
+  _intervals = 0;
+}
+
+//Starts a measurement when its deadline has come and reads it once ready
+SGP30ERR SGP30Scheduler::update(void)
+{
+  if (_sensor == NULL)
+    return SGP30_ERR_NOT_READY;
+
+  if (_measuring)
+  {
+    if (!_sensor->isPending(measure_air_quality))
+    {
+      _measuring = false; //dropped by a reset or cancel(), its reading is gone
+      lost++;
+      return SGP30_ERR_NOT_READY;
+    }
+    if (!_sensor->isReady())
+      return SGP30_ERR_NOT_READY;
+    _measuring = false;
+    return _sensor->readAirQuality();
+  }
+
+  uint32_t late = (uint32_t)millis() - _deadline;
+  if ((int32_t)late < 0)
+    return SGP30_ERR_NOT_READY; //not due yet
+
+  //A whole period or more behind: skip to the latest deadline, keeping the phase
+  if (late >= _period)
+  {
+    uint32_t skipped = late / _period;
+    missed += skipped;
+    _deadline += skipped * _period;
+    late -= skipped * _period;
+    _consecutive = false;
+  }
+
+  SGP30ERR error = _sensor->startAirQuality();
+  if (error == SGP30_ERR_BUSY)
+    return error; //someone else's command, try again on the next call
+  _recordInterval(micros());
+  if (late > maxLateness)
+    maxLateness = late;
+  ticks++;
+  _deadline += _period;
+  if (error != SGP30_SUCCESS)
+    return error;
+  _measuring = true;
+  return SGP30_ERR_NOT_READY;
+}
+
+//Milliseconds until update() has something to do
+unsigned long SGP30Scheduler::msUntilNext(void)
+{
+  if (_sensor == NULL)
+    return 0;
+  if (_measuring)
+    return _sensor->msUntilReady();
+  uint32_t left = _deadline - (uint32_t)millis();
+  if ((int32_t)left < 0)
+    return 0; //overdue
+  return left;
+}
+
+//Mean difference between an interval and the period, us
+unsigned long SGP30Scheduler::meanJitter(void)
+{
+  if (_intervals == 0)
+    return 0;
+  return (unsigned long)((_jitterSum + _intervals / 2) / _intervals);
+}
+
+//Only intervals between consecutive ticks count, a skipped deadline is in missed
+void SGP30Scheduler::_recordInterval(uint32_t now)
+{
+  if (_consecutive)
+  {
+    uint32_t interval = now - _lastStart;
+    uint32_t period = _period * 1000;
+    uint32_t jitter = interval > period ? interval - period : period - interval;
+    if (_intervals == 0 || interval < minInterval)
+      minInterval = interval;
+    if (interval > maxInterval)
+      maxInterval = interval;
+    if (jitter > maxJitter)
+      maxJitter = jitter;
+    _jitterSum += jitter;
+    _intervals++;
+  }
+  _consecutive = true;
+  _lastStart = now;
+}
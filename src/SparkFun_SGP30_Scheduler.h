@@ -0,0 +1,81 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Keeps measureAirQuality() on the 1 second cadence the sensor's dynamic
+  baseline needs.
+  Deadlines are absolute: each one is the previous deadline plus the period,
+  not the time the last measurement happened plus the period, so a late
+  loop delays one measurement without shifting every later one. Deadlines
+  are compared with 32 bit unsigned subtraction, so millis() rolling over
+  after 49.7 days is harmless, also on hosts where unsigned long is 64
+  bits. If the loop falls more than a period behind, the deadlines that
+  were missed are skipped and counted rather than run back to back.
+  msUntilNext() tells how long the MCU may sleep before update() has work
+  to do, and the cadence statistics (interval jitter, lateness, missed
+  ticks) show how well the sketch keeps up.
+  If the measurement in flight is dropped before update() reads it, by a
+  reset or cancel(), update() counts the reading as lost and carries on
+  with the next deadline instead of waiting for it.
+*/
+
+#ifndef SparkFun_SGP30_Scheduler_h
+#define SparkFun_SGP30_Scheduler_h
+
+#include "SparkFun_SGP30_Arduino_Library.h"
+
+class SGP30Scheduler
+{
+public:
+  //Cadence statistics since begin() or resetStats()
+  unsigned long ticks;       //measurements started
+  unsigned long missed;      //deadlines skipped because the loop was a whole period late
+  unsigned long lost;        //measurements started but dropped before they were read
+  unsigned long minInterval; //shortest and longest time between consecutive starts, us
+  unsigned long maxInterval;
+  unsigned long maxJitter;   //largest difference between an interval and the period, us
+  unsigned long maxLateness; //longest time from a deadline to its start, ms
+
+  //period in ms, 1000 for air quality
+  SGP30Scheduler(unsigned long period = 1000);
+
+  //Schedules measurements on sensor, the first one right away
+  //Call after initAirQuality()
+  void begin(SGP30 &sensor);
+
+  //Call from loop() as often as convenient
+  //Starts a measurement when its deadline has come and reads it once ready
+  //Returns SGP30_SUCCESS when a new reading has been published in the
+  //sensor's fields, SGP30_ERR_NOT_READY when there was nothing new (also
+  //while SGP30Recovery holds the last values after a re-init), or the
+  //error of the start or read
+  //SGP30_ERR_BUSY means another command was in progress, the start is retried
+  SGP30ERR update(void);
+
+  //Milliseconds until update() has something to do, 0 if it has now
+  //Safe to sleep this long between calls
+  unsigned long msUntilNext(void);
+
+  //millis() value of the next start
+  unsigned long deadline(void) { return _deadline; }
+
+  //Mean difference between an interval and the period, us
+  unsigned long meanJitter(void);
+
+  void resetStats(void);
+
+private:
+  SGP30 *_sensor;
+  unsigned long _period;
+  uint32_t _deadline;        //millis() of the next start
+  bool _measuring;           //our measurement is in progress
+  bool _consecutive;         //the last start was the tick right before this one
+  uint32_t _lastStart;       //micros() of the last start
+  uint64_t _jitterSum;       //over _intervals
+  unsigned long _intervals;
+
+  //Records the interval since the last start
+  void _recordInterval(uint32_t now);
+};
+
+#endif
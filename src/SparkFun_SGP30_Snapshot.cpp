@@ -0,0 +1,44 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Seqlock protected snapshot of the SGP30's results, see SparkFun_SGP30_Snapshot.h
+*/
+
+#include "SparkFun_SGP30_Snapshot.h"
+
+SGP30SnapshotCell::SGP30SnapshotCell()
+{
+  _sequence = 0;
+  SGP30Snapshot none = {0, 0, 0, 0, 0, 0, 0, 0};
+  _data = none;
+}
+
+void SGP30SnapshotCell::publish(const SGP30Snapshot &snapshot)
+{
+  sgp30_sequence_t sequence = __atomic_load_n(&_sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&_sequence, (sgp30_sequence_t)(sequence + 1), __ATOMIC_RELAXED);
+  //Readers that see any of the new data also see the odd counter
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  uint32_t published = _data.sequence + 1;
+  _data = snapshot;
+  _data.sequence = published;
+  __atomic_store_n(&_sequence, (sgp30_sequence_t)(sequence + 2), __ATOMIC_RELEASE);
+}
+
+bool SGP30SnapshotCell::tryRead(SGP30Snapshot &snapshot) const
+{
+  sgp30_sequence_t before = __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE);
+  if (before & 1)
+    return false;
+  snapshot = _data;
+  //The copy completes before the counter is checked again
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&_sequence, __ATOMIC_RELAXED) == before;
+}
+
+void SGP30SnapshotCell::read(SGP30Snapshot &snapshot) const
+{
+  while (!tryRead(snapshot))
+    ;
+}
@@ -0,0 +1,69 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Consistent copies of the SGP30's results for other tasks, threads and ISRs.
+
+  The public fields (CO2, TVOC...) are written one at a time, so a reader
+  running concurrently with the measuring code can see CO2 from one
+  measurement and TVOC from the next. After every successful measurement
+  (air quality or raw signals) the driver also publishes all of its
+  results together as an SGP30Snapshot, guarded by a sequence counter
+  (seqlock): it is odd while a snapshot is being written, and a reader's
+  copy is only good if the counter was even and unchanged from before to
+  after the copy.
+    - the writer never waits for readers
+    - tryRead() makes a single attempt and is wait-free, safe in ISRs
+    - read() retries until it succeeds; it must not be called from an
+      ISR or a higher priority task on the writer's core, which could have
+      interrupted the writer and would then spin forever
+  There must be one writer: the code calling the SGP30's measurement
+  methods. The counter is accessed with the __atomic builtins; it is a
+  single byte on AVR, where wider loads are not atomic.
+*/
+
+#ifndef SparkFun_SGP30_Snapshot_h
+#define SparkFun_SGP30_Snapshot_h
+
+#include "Arduino.h"
+
+//The SGP30's results as of one moment
+struct SGP30Snapshot
+{
+  uint32_t sequence;       //snapshots published so far, 0 until the first measurement
+  unsigned long timestamp; //millis() when the newest measurement was started
+  uint16_t CO2;
+  uint16_t TVOC;
+  uint16_t baselineCO2;
+  uint16_t baselineTVOC;
+  uint16_t H2;
+  uint16_t ethanol;
+};
+
+#if defined(__AVR__)
+typedef uint8_t sgp30_sequence_t;
+#else
+typedef uint32_t sgp30_sequence_t;
+#endif
+
+//Single writer, any number of readers
+class SGP30SnapshotCell
+{
+public:
+  SGP30SnapshotCell();
+
+  //Replaces the snapshot, its sequence is set to the number of publications
+  void publish(const SGP30Snapshot &snapshot);
+
+  //One attempt, returns false if a publish was in progress
+  bool tryRead(SGP30Snapshot &snapshot) const;
+
+  //Retries until it gets a consistent copy
+  void read(SGP30Snapshot &snapshot) const;
+
+private:
+  sgp30_sequence_t _sequence; //odd while publishing
+  SGP30Snapshot _data;
+};
+
+#endif
@@ -0,0 +1,65 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Optional instrumentation counters for the SGP30 driver.
+  With SGP30_ENABLE_STATS defined every SGP30 keeps, per command, how often
+  it was sent, how many responses failed their checksum or were not
+  acknowledged, and the latency from sending the command to the end of
+  its response (or of the write, for commands without one), measured with
+  micros(). The bytes moved over the bus are counted as well.
+  Without it the counters, and the code updating them, are not compiled.
+
+  SGP30_ENABLE_STATS changes the layout of SGP30, so it must be seen by
+  the library's .cpp files as well as the sketch: uncomment the line below,
+  or define it for the whole build (e.g. PlatformIO build_flags).
+  The counters take about 360 bytes of RAM per sensor.
+*/
+
+#ifndef SparkFun_SGP30_Stats_h
+#define SparkFun_SGP30_Stats_h
+
+#include "Arduino.h"
+
+//#define SGP30_ENABLE_STATS
+
+//Commands, in the order of SGP30Stats::commands
+typedef enum
+{
+  SGP30_CMD_INIT_AIR_QUALITY = 0,
+  SGP30_CMD_MEASURE_AIR_QUALITY,
+  SGP30_CMD_GET_BASELINE,
+  SGP30_CMD_SET_BASELINE,
+  SGP30_CMD_SET_HUMIDITY,
+  SGP30_CMD_MEASURE_TEST,
+  SGP30_CMD_GET_FEATURE_SET_VERSION,
+  SGP30_CMD_GET_SERIAL_ID,
+  SGP30_CMD_MEASURE_RAW_SIGNALS,
+  SGP30_CMD_GET_TVOC_INCEPTIVE_BASELINE,
+  SGP30_CMD_SET_TVOC_BASELINE
+} SGP30COMMAND;
+
+#define SGP30_COMMANDS 11
+
+struct SGP30CommandStats
+{
+  uint32_t calls;      //times the command was sent
+  uint32_t badCRC;     //responses that failed their checksum
+  uint32_t timeouts;   //command writes or response reads not acknowledged
+  uint32_t completed;  //successful, the ones timed below
+  uint32_t latencyMin; //us
+  uint32_t latencyMax;
+  uint64_t latencySum;
+
+  //Average latency in us, 0 before the first completion
+  uint32_t latencyAverage(void) const { return completed ? (uint32_t)(latencySum / completed) : 0; }
+};
+
+struct SGP30Stats
+{
+  SGP30CommandStats commands[SGP30_COMMANDS]; //indexed by SGP30COMMAND
+  uint32_t bytesSent;                         //command frames, including checksums
+  uint32_t bytesReceived;                     //response frames, including checksums
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Bus transaction trace, see SparkFun_SGP30_Trace.h
+*/
+
+#include "SparkFun_SGP30_Trace.h"
+
+SGP30TraceRecorder::SGP30TraceRecorder(Print &output)
+{
+  _output = &output;
+  _transport = NULL;
+  begin();
+}
+
+//Starts a new trace, the header goes out with the first transaction
+void SGP30TraceRecorder::begin(void)
+{
+  transactions = 0;
+  bytes = 0;
+  _last = 0;
+  _started = false;
+}
+
+bool SGP30TraceRecorder::write(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  bool ok = _transport != NULL && _transport->write(address, data, length);
+  _record(ok ? 0 : SGP30_TRACE_FAILED, address, data, length);
+  return ok;
+}
+
+bool SGP30TraceRecorder::read(uint8_t address, uint8_t *data, uint8_t length)
+{
+  bool ok = _transport != NULL && _transport->read(address, data, length);
+  _record(SGP30_TRACE_READ | (ok ? 0 : SGP30_TRACE_FAILED), address, data, length);
+  return ok;
+}
+
+//Encodes one transaction and hands it to the output, in one write unless it is long
+void SGP30TraceRecorder::_record(uint8_t tag, uint8_t address, const uint8_t *data, uint8_t length)
+{
+  //Header, tag, 5 byte varint, address, length, then the bytes of any SGP30 frame
+  uint8_t record[SGP30_TRACE_HEADER + 8 + 32];
+  uint8_t size = 0;
+  unsigned long now = millis();
+  if (!_started)
+  {
+    record[size++] = 'S';
+    record[size++] = 'G';
+    record[size++] = 'T';
+    record[size++] = SGP30_TRACE_VERSION;
+    for (uint8_t i = 0; i < 4; i++)
+      record[size++] = (uint8_t)(now >> (8 * i));
+    _last = now;
+    _started = true;
+  }
+  if (address != SGP30_TRACE_DEFAULT_ADDRESS)
+    tag |= SGP30_TRACE_ADDRESS;
+  record[size++] = tag | (length < SGP30_TRACE_LENGTH ? length : SGP30_TRACE_LENGTH);
+  uint32_t elapsed = (uint32_t)(now - _last);
+  _last = now;
+  while (elapsed >= 0x80)
+  {
+    record[size++] = (uint8_t)(elapsed | 0x80);
+    elapsed >>= 7;
+  }
+  record[size++] = (uint8_t)elapsed;
+  if (tag & SGP30_TRACE_ADDRESS)
+    record[size++] = address;
+  if (length >= SGP30_TRACE_LENGTH)
+    record[size++] = length;
+  //The bytes of a failed read mean nothing
+  if ((tag & SGP30_TRACE_READ) && (tag & SGP30_TRACE_FAILED))
+    length = 0;
+  if (size + length <= sizeof(record))
+  {
+    memcpy(record + size, data, length);
+    bytes += _output->write(record, size + length);
+  }
+  else
+  {
+    bytes += _output->write(record, size);
+    bytes += _output->write(data, length);
+  }
+  transactions++;
+}
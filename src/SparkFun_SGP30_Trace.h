@@ -0,0 +1,70 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Bus transaction trace, to reproduce on the bench what a sensor did in
+  the field. SGP30TraceRecorder is a transport that passes every
+  transaction on to the real one and writes it to any Print (Serial,
+  File...). Attach it with SGP30::attachRecorder(), or wrap a transport
+  with setTransport() and begin() any driver with the recorder.
+  The trace is a header then one record per transaction:
+    header  'S' 'G' 'T', version, millis() at the start (4 bytes, LSB first)
+    record  tag, ms since the previous record (varint), address if not
+            the SGP30's, length if 31 or more, then the bytes
+  Tag: bit 7 read, bit 6 failed, bit 5 address follows, bits 4-0 length
+  (31: a length byte follows). Writes keep the bytes sent, command and
+  parameters, even when not acknowledged; reads keep the bytes received,
+  none when the read failed. A measurement takes about 13 bytes.
+  extras/host/SGP30Replay.h feeds a trace back through the driver.
+*/
+
+#ifndef SparkFun_SGP30_Trace_h
+#define SparkFun_SGP30_Trace_h
+
+#include "Arduino.h"
+#include "SparkFun_SGP30_Transport.h"
+
+#define SGP30_TRACE_VERSION 1
+
+//Header: magic, version, start time
+#define SGP30_TRACE_HEADER 8
+
+//Record tag bits
+#define SGP30_TRACE_READ 0x80
+#define SGP30_TRACE_FAILED 0x40
+#define SGP30_TRACE_ADDRESS 0x20
+#define SGP30_TRACE_LENGTH 0x1F
+
+//Address a record omits
+#define SGP30_TRACE_DEFAULT_ADDRESS 0x58
+
+class SGP30TraceRecorder : public SGP30Transport
+{
+public:
+  //Transactions recorded and bytes written to the output since begin()
+  unsigned long transactions;
+  unsigned long bytes;
+
+  SGP30TraceRecorder(Print &output);
+
+  //Starts a new trace, the header goes out with the first transaction
+  void begin(void);
+
+  //Transport the transactions are passed on to
+  void setTransport(SGP30Transport &transport) { _transport = &transport; }
+  SGP30Transport *transport(void) { return _transport; }
+
+  //Fail without a transport to pass them on to
+  bool write(uint8_t address, const uint8_t *data, uint8_t length);
+  bool read(uint8_t address, uint8_t *data, uint8_t length);
+
+private:
+  Print *_output;
+  SGP30Transport *_transport;
+  unsigned long _last; //millis() of the previous record
+  bool _started;       //header written
+
+  void _record(uint8_t tag, uint8_t address, const uint8_t *data, uint8_t length);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  TwoWire and memory transports, see SparkFun_SGP30_Transport.h
+*/
+
+#include "SparkFun_SGP30_Transport.h"
+#include "SparkFun_SGP30_CRC.h"
+
+bool SGP30TwoWireTransport::write(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  _port->beginTransmission(address);
+  _port->write(data, length);
+  return _port->endTransmission() == 0;
+}
+
+bool SGP30TwoWireTransport::read(uint8_t address, uint8_t *data, uint8_t length)
+{
+  if (_port->requestFrom(address, length) != length)
+    return false;
+  for (uint8_t i = 0; i < length; i++)
+    data[i] = _port->read();
+  return true;
+}
+
+SGP30MemoryTransport::SGP30MemoryTransport()
+{
+  nack = false;
+  clear();
+}
+
+//Forgets queued responses, the last write and the counters
+void SGP30MemoryTransport::clear(void)
+{
+  lastWriteLength = 0;
+  lastAddress = 0;
+  writes = 0;
+  reads = 0;
+  _responseLength = 0;
+  _responseIndex = 0;
+}
+
+//Queues raw bytes for the following read()s
+bool SGP30MemoryTransport::respond(const uint8_t *data, uint8_t length)
+{
+  //Reclaim what has been read already
+  if (_responseIndex > 0)
+  {
+    memmove(_response, &_response[_responseIndex], _responseLength - _responseIndex);
+    _responseLength -= _responseIndex;
+    _responseIndex = 0;
+  }
+  if (length > SGP30_MEMORY_TRANSPORT_LENGTH - _responseLength)
+    return false;
+  memcpy(&_response[_responseLength], data, length);
+  _responseLength += length;
+  return true;
+}
+
+//Queues words as MSB / LSB / Checksum
+bool SGP30MemoryTransport::respondWords(const uint16_t *words, uint8_t count)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint8_t frame[3] = {(uint8_t)(words[i] >> 8), (uint8_t)words[i], sgp30CRC8Word(words[i])};
+    if (!respond(frame, 3))
+      return false;
+  }
+  return true;
+}
+
+bool SGP30MemoryTransport::write(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  writes++;
+  if (nack)
+    return false;
+  if (length > SGP30_MEMORY_TRANSPORT_LENGTH)
+    length = SGP30_MEMORY_TRANSPORT_LENGTH;
+  memcpy(lastWrite, data, length);
+  lastWriteLength = length;
+  lastAddress = address;
+  return true;
+}
+
+bool SGP30MemoryTransport::read(uint8_t address, uint8_t *data, uint8_t length)
+{
+  (void)address;
+  reads++;
+  if (nack || pending() < length)
+    return false;
+  memcpy(data, &_response[_responseIndex], length);
+  _responseIndex += length;
+  return true;
+}
@@ -0,0 +1,94 @@
+/*
+  Part of the SparkFun SGP30 Arduino Library
+  https://github.com/sparkfun/SparkFun_SGP30_Arduino_Library
+
+  Bus access for the SGP30 driver.
+  The driver talks to the sensor through SGP30Transport, one whole frame
+  per call, so the same code runs over:
+    SGP30TwoWireTransport  Arduino Wire, used by SGP30::begin(TwoWire&)
+    SGP30MemoryTransport   canned responses and recorded writes, for tests
+    SGP30LinuxI2C          /dev/i2c-N on Linux, see SparkFun_SGP30_LinuxI2C.h
+  SGP30TraceRecorder (SparkFun_SGP30_Trace.h) sits in front of any of them
+  and records the traffic.
+*/
+
+#ifndef SparkFun_SGP30_Transport_h
+#define SparkFun_SGP30_Transport_h
+
+#include "Arduino.h"
+#include <Wire.h>
+
+class SGP30Transport
+{
+public:
+  //Writes length bytes to the device at address as one transaction
+  //Returns false if the device did not acknowledge
+  virtual bool write(uint8_t address, const uint8_t *data, uint8_t length) = 0;
+
+  //Reads length bytes from the device at address as one transaction
+  //Returns false unless every byte was received
+  virtual bool read(uint8_t address, uint8_t *data, uint8_t length) = 0;
+};
+
+//Arduino Wire (or any TwoWire port)
+class SGP30TwoWireTransport : public SGP30Transport
+{
+public:
+  SGP30TwoWireTransport(TwoWire &port = Wire) { _port = &port; }
+
+  void setPort(TwoWire &port) { _port = &port; }
+
+  bool write(uint8_t address, const uint8_t *data, uint8_t length);
+  bool read(uint8_t address, uint8_t *data, uint8_t length);
+
+private:
+  TwoWire *_port;
+};
+
+//Bytes a memory transport can queue and record
+#define SGP30_MEMORY_TRANSPORT_LENGTH 64
+
+//In-memory bus for tests: read() hands out queued bytes, write() records
+//the last transaction
+class SGP30MemoryTransport : public SGP30Transport
+{
+public:
+  //Last transaction written and where it went
+  uint8_t lastWrite[SGP30_MEMORY_TRANSPORT_LENGTH];
+  uint8_t lastWriteLength;
+  uint8_t lastAddress;
+
+  //Transactions seen
+  unsigned long writes;
+  unsigned long reads;
+
+  //When true every transaction fails, like a missing device
+  bool nack;
+
+  SGP30MemoryTransport();
+
+  //Forgets queued responses, the last write and the counters
+  void clear(void);
+
+  //Queues raw bytes for the following read()s
+  //Returns false if they don't fit
+  bool respond(const uint8_t *data, uint8_t length);
+
+  //Queues words with their checksums, as the sensor would send them
+  bool respondWords(const uint16_t *words, uint8_t count);
+
+  //Bytes queued and not read yet
+  uint8_t pending(void) { return _responseLength - _responseIndex; }
+
+  bool write(uint8_t address, const uint8_t *data, uint8_t length);
+
+  //Fails without consuming anything if fewer than length bytes are queued
+  bool read(uint8_t address, uint8_t *data, uint8_t length);
+
+private:
+  uint8_t _response[SGP30_MEMORY_TRANSPORT_LENGTH];
+  uint8_t _responseLength;
+  uint8_t _responseIndex;
+};
+
+#endif